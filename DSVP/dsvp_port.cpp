@@ -0,0 +1,314 @@
+/* DSVP: Lock-free multi-producer/single-consumer ports and doorbells for DS units.
+AUTHOR: Dmitry I. Lyakh (Liakh): quant4me@gmail.com
+REVISION: 2020/06/09
+
+Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
+
+This file is part of ExaTensor.
+
+ExaTensor is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ExaTensor is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.*/
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <new>
+
+#include "dsvp_port.h"
+
+namespace {
+
+//Cache line size (to keep producer and consumer positions apart):
+constexpr std::size_t CACHE_LINE = 64;
+
+struct PortSlot{
+ std::atomic<std::size_t> seq; //slot sequence number: position (free) or position+1 (filled)
+ void * item;                  //stored item
+};
+
+/** Bounded MPSC ring buffer with per-slot sequence numbers: A producer claims
+    a position by advancing the tail with CAS, then publishes the slot by bumping
+    its sequence number. The single consumer reads slots strictly in position order. **/
+struct DSVPPort{
+ std::size_t capacity;                                 //number of slots (power of 2)
+ std::size_t mask;                                     //capacity - 1
+ PortSlot * slots;                                     //ring slots
+ alignas(CACHE_LINE) std::atomic<std::size_t> tail;    //next position to be claimed by producers
+ alignas(CACHE_LINE) std::atomic<std::size_t> head;    //next position to be read by the consumer
+ std::atomic<void*> stash;                             //item peeked by the consumer, but not yet popped
+ alignas(CACHE_LINE) std::atomic<std::size_t> overflow_size; //number of items in the overflow queue
+ std::mutex overflow_lock;                             //overflow queue lock
+ std::deque<void*> overflow;                           //overflow queue (only used when the ring is full)
+};
+
+/** Event count: A waiter registers itself as a sleeper before checking the ring
+    count under the lock, whereas a ringer bumps the ring count before checking
+    for sleepers, thus either the waiter sees the new count or the ringer sees the waiter. **/
+struct DSVPDoorbell{
+ std::atomic<long long int> rings;  //number of rings so far
+ std::atomic<int> sleepers;         //number of threads sleeping (or about to sleep) on the doorbell
+ std::mutex lock;                   //condition variable lock
+ std::condition_variable cond;      //condition variable
+};
+
+//Pushes a single item into the ring (returns false if the ring is full):
+bool ring_push(DSVPPort * port, void * item)
+{
+ std::size_t pos = port->tail.load(std::memory_order_relaxed);
+ while(true){
+  PortSlot * slot = &(port->slots[pos & port->mask]);
+  std::size_t seq = slot->seq.load(std::memory_order_acquire);
+  std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+  if(diff == 0){
+   if(port->tail.compare_exchange_weak(pos,pos+1,std::memory_order_relaxed)) break;
+  }else if(diff < 0){
+   return false; //full
+  }else{
+   pos = port->tail.load(std::memory_order_relaxed);
+  }
+ }
+ PortSlot * slot = &(port->slots[pos & port->mask]);
+ slot->item = item;
+ slot->seq.store(pos+1,std::memory_order_release);
+ return true;
+}
+
+//Pushes a batch of items into consecutive ring positions with a single claim (returns false if no room):
+bool ring_push_batch(DSVPPort * port, std::size_t num_items, void * items[])
+{
+ if(num_items == 0) return true;
+ if(num_items > port->capacity) return false;
+ std::size_t pos = port->tail.load(std::memory_order_relaxed);
+ while(true){
+  //The consumer frees slots in position order, thus if the last slot of the range is free, so are all others:
+  std::size_t last = pos + num_items - 1;
+  std::size_t seq = port->slots[last & port->mask].seq.load(std::memory_order_acquire);
+  std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(last);
+  if(diff == 0){
+   if(port->tail.compare_exchange_weak(pos,pos+num_items,std::memory_order_relaxed)) break;
+  }else if(diff < 0){
+   return false; //not enough room
+  }else{
+   pos = port->tail.load(std::memory_order_relaxed);
+  }
+ }
+ for(std::size_t i = 0; i < num_items; ++i){
+  PortSlot * slot = &(port->slots[(pos+i) & port->mask]);
+  slot->item = items[i];
+  slot->seq.store(pos+i+1,std::memory_order_release);
+ }
+ return true;
+}
+
+//Pops a single item from the ring (consumer only, returns NULL if nothing has been published yet):
+void * ring_pop(DSVPPort * port)
+{
+ std::size_t pos = port->head.load(std::memory_order_relaxed);
+ PortSlot * slot = &(port->slots[pos & port->mask]);
+ if(slot->seq.load(std::memory_order_acquire) != pos+1) return NULL;
+ void * item = slot->item;
+ slot->seq.store(pos+port->capacity,std::memory_order_release);
+ port->head.store(pos+1,std::memory_order_release);
+ return item;
+}
+
+//Appends items to the overflow queue:
+void overflow_push(DSVPPort * port, std::size_t num_items, void * items[])
+{
+ std::lock_guard<std::mutex> lock(port->overflow_lock);
+ for(std::size_t i = 0; i < num_items; ++i) port->overflow.push_back(items[i]);
+ port->overflow_size.store(port->overflow.size(),std::memory_order_release);
+ return;
+}
+
+//Pops the next item from the port bypassing the stash (consumer only):
+void * port_pop(DSVPPort * port)
+{
+ void * item = ring_pop(port);
+ if(item == NULL && port->overflow_size.load(std::memory_order_acquire) > 0){
+  //The overflow queue is only drained when the ring is truly empty (no claimed slots),
+  //otherwise a producer could see its earlier ring item popped after its later overflow item:
+  if(port->tail.load(std::memory_order_acquire) == port->head.load(std::memory_order_relaxed)){
+   std::lock_guard<std::mutex> lock(port->overflow_lock);
+   if(!(port->overflow.empty())){
+    item = port->overflow.front(); port->overflow.pop_front();
+    port->overflow_size.store(port->overflow.size(),std::memory_order_release);
+   }
+  }
+ }
+ return item;
+}
+
+} //namespace
+
+
+void * dsvp_port_create(int capacity)
+{
+ if(capacity <= 0) return NULL;
+ std::size_t cap = 1;
+ while(cap < static_cast<std::size_t>(capacity)) cap <<= 1;
+ DSVPPort * port = new(std::nothrow) DSVPPort;
+ if(port == NULL) return NULL;
+ port->slots = new(std::nothrow) PortSlot[cap];
+ if(port->slots == NULL){delete port; return NULL;}
+ for(std::size_t i = 0; i < cap; ++i){
+  port->slots[i].seq.store(i,std::memory_order_relaxed);
+  port->slots[i].item = NULL;
+ }
+ port->capacity = cap; port->mask = cap - 1;
+ port->tail.store(0,std::memory_order_relaxed);
+ port->head.store(0,std::memory_order_relaxed);
+ port->stash.store(NULL,std::memory_order_relaxed);
+ port->overflow_size.store(0,std::memory_order_relaxed);
+ std::atomic_thread_fence(std::memory_order_release);
+ return static_cast<void*>(port);
+}
+
+void dsvp_port_destroy(void * port)
+{
+ DSVPPort * prt = static_cast<DSVPPort*>(port);
+ if(prt != NULL){
+  delete [] prt->slots;
+  delete prt;
+ }
+ return;
+}
+
+int dsvp_port_push(void * port, void * item)
+{
+ DSVPPort * prt = static_cast<DSVPPort*>(port);
+ if(prt == NULL || item == NULL) return -1;
+ if(prt->overflow_size.load(std::memory_order_acquire) == 0){
+  if(ring_push(prt,item)) return 0;
+ }
+ overflow_push(prt,1,&item);
+ return 0;
+}
+
+int dsvp_port_push_batch(void * port, int num_items, void * items[])
+{
+ DSVPPort * prt = static_cast<DSVPPort*>(port);
+ if(prt == NULL || num_items < 0) return -1;
+ std::size_t n = static_cast<std::size_t>(num_items);
+ std::size_t i = 0;
+ if(prt->overflow_size.load(std::memory_order_acquire) == 0){
+  if(ring_push_batch(prt,n,items)) return 0;
+  while(i < n){if(!ring_push(prt,items[i])) break; ++i;} //not enough room for the whole batch
+ }
+ if(i < n) overflow_push(prt,n-i,&(items[i]));
+ return 0;
+}
+
+void * dsvp_port_front(void * port)
+{
+ DSVPPort * prt = static_cast<DSVPPort*>(port);
+ if(prt == NULL) return NULL;
+ void * item = prt->stash.load(std::memory_order_relaxed);
+ if(item == NULL){
+  item = port_pop(prt);
+  if(item != NULL) prt->stash.store(item,std::memory_order_release);
+ }
+ return item;
+}
+
+void * dsvp_port_pop(void * port)
+{
+ DSVPPort * prt = static_cast<DSVPPort*>(port);
+ if(prt == NULL) return NULL;
+ void * item = prt->stash.load(std::memory_order_relaxed);
+ if(item != NULL){
+  prt->stash.store(NULL,std::memory_order_release);
+ }else{
+  item = port_pop(prt);
+ }
+ return item;
+}
+
+int dsvp_port_pop_batch(void * port, int max_items, void * items[])
+{
+ int n = 0;
+ while(n < max_items){
+  void * item = dsvp_port_pop(port);
+  if(item == NULL) break;
+  items[n++] = item;
+ }
+ return n;
+}
+
+long long int dsvp_port_size(void * port)
+{
+ DSVPPort * prt = static_cast<DSVPPort*>(port);
+ if(prt == NULL) return 0;
+ std::size_t head = prt->head.load(std::memory_order_acquire);
+ std::size_t tail = prt->tail.load(std::memory_order_acquire);
+ long long int n = static_cast<long long int>(tail - head);
+ if(n < 0) n = 0;
+ n += static_cast<long long int>(prt->overflow_size.load(std::memory_order_acquire));
+ if(prt->stash.load(std::memory_order_acquire) != NULL) ++n;
+ return n;
+}
+
+void * dsvp_doorbell_create()
+{
+ DSVPDoorbell * doorbell = new(std::nothrow) DSVPDoorbell;
+ if(doorbell != NULL){
+  doorbell->rings.store(0);
+  doorbell->sleepers.store(0);
+ }
+ return static_cast<void*>(doorbell);
+}
+
+void dsvp_doorbell_destroy(void * doorbell)
+{
+ delete static_cast<DSVPDoorbell*>(doorbell);
+ return;
+}
+
+long long int dsvp_doorbell_key(void * doorbell)
+{
+ DSVPDoorbell * dbl = static_cast<DSVPDoorbell*>(doorbell);
+ if(dbl == NULL) return 0;
+ return dbl->rings.load();
+}
+
+void dsvp_doorbell_ring(void * doorbell)
+{
+ DSVPDoorbell * dbl = static_cast<DSVPDoorbell*>(doorbell);
+ if(dbl == NULL) return;
+ dbl->rings.fetch_add(1);
+ if(dbl->sleepers.load() > 0){
+  std::lock_guard<std::mutex> lock(dbl->lock);
+  dbl->cond.notify_all();
+ }
+ return;
+}
+
+int dsvp_doorbell_wait(void * doorbell, long long int key, double max_wait)
+{
+ DSVPDoorbell * dbl = static_cast<DSVPDoorbell*>(doorbell);
+ if(dbl == NULL) return 0;
+ if(dbl->rings.load() != key) return 1;
+ if(max_wait <= 0.0) return 0;
+ dbl->sleepers.fetch_add(1);
+ bool rung = false;
+ {
+  std::unique_lock<std::mutex> lock(dbl->lock);
+  rung = dbl->cond.wait_for(lock,std::chrono::duration<double>(max_wait),[dbl,key]{return dbl->rings.load() != key;});
+ }
+ dbl->sleepers.fetch_sub(1);
+ return (rung ? 1 : 0);
+}
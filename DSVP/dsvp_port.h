@@ -0,0 +1,61 @@
+/* DSVP: Lock-free multi-producer/single-consumer ports and doorbells for DS units.
+AUTHOR: Dmitry I. Lyakh (Liakh): quant4me@gmail.com
+REVISION: 2020/06/09
+
+Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
+
+This file is part of ExaTensor.
+
+ExaTensor is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ExaTensor is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
+
+NOTES:
+ # A DS unit port is a bounded lock-free ring buffer of opaque pointers
+   which any number of producer threads may push into concurrently and
+   which exactly one consumer thread (the DS unit owning the port) pops from.
+   Items pushed by the same producer are always popped in the same order.
+ # The ring never rejects an item: If it is full, the item goes into a locked
+   overflow queue which is drained by the consumer once the ring is empty.
+   While the overflow queue is non-empty, producers keep appending to it,
+   thus preserving the per-producer order.
+ # dsvp_port_front() and dsvp_port_pop*() must only be called by the consumer.
+ # A DS unit doorbell lets an idle DS unit sleep until one of its ports is loaded:
+   The DS unit takes a key, checks its ports and, if they are all empty, waits
+   with that key. A ring after the key was taken wakes it up (no lost wakeups).
+*/
+
+#ifndef DSVP_PORT_H_
+#define DSVP_PORT_H_
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+ void * dsvp_port_create(int capacity);                     //creates a new port with a ring of <capacity> slots (rounded up to a power of 2)
+ void dsvp_port_destroy(void * port);                       //destroys the port (must be empty)
+ int dsvp_port_push(void * port, void * item);              //pushes an item into the port (producers)
+ int dsvp_port_push_batch(void * port, int num_items, void * items[]); //pushes a batch of items into the port in order (producers)
+ void * dsvp_port_front(void * port);                       //returns the next item without removing it, or NULL (consumer)
+ void * dsvp_port_pop(void * port);                         //removes and returns the next item, or NULL (consumer)
+ int dsvp_port_pop_batch(void * port, int max_items, void * items[]); //removes up to <max_items> items, returns their number (consumer)
+ long long int dsvp_port_size(void * port);                 //returns the (approximate) number of items in the port
+ void * dsvp_doorbell_create();                             //creates a new doorbell
+ void dsvp_doorbell_destroy(void * doorbell);               //destroys the doorbell (nobody must be waiting on it)
+ long long int dsvp_doorbell_key(void * doorbell);          //returns the current doorbell key (number of rings so far)
+ void dsvp_doorbell_ring(void * doorbell);                  //rings the doorbell, waking up all waiters
+ int dsvp_doorbell_wait(void * doorbell, long long int key, double max_wait); //sleeps until a ring after <key> or <max_wait> sec elapsed (returns 1 if rung)
+#ifdef __cplusplus
+}
+#endif
+
+#endif //DSVP_PORT_H_
@@ -2,7 +2,7 @@
 implementation of the tensor algebra library TAL-SH:
 CP-TAL (TAL for CPU), NV-TAL (TAL for NVidia GPU),
 XP-TAL (TAL for Intel Xeon Phi), AM-TAL (TAL for AMD GPU).
-REVISION: 2020/04/12
+REVISION: 2020/07/14
 
 Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
 Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
@@ -34,8 +34,11 @@ FOR DEVELOPERS ONLY:
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <time.h>
 
+#include <atomic>
+
 #include <omp.h>
 
 #include "tensor_algebra.h"
@@ -48,6 +51,10 @@ FOR DEVELOPERS ONLY:
 #define BLCK_BUF_DEPTH_HOST 13       //number of distinct tensor block buffer levels on Host
 #define BLCK_BUF_TOP_HOST 3          //number of argument buffer entries of the largest size (level 0) on Host: multiple of 3
 #define BLCK_BUF_BRANCH_HOST 2       //branching factor for each subsequent buffer level on Host
+#define BLCK_CACHE_SHARDS_HOST 64    //number of shards of the cache of the lowest-level Host argument buffer entries
+#define BLCK_CACHE_DEPTH_HOST 16     //max number of cached lowest-level entries per shard
+#define BLCK_CACHE_REFILL_HOST 8     //number of lowest-level entries moved from the Host argument buffer into an empty shard at once
+#define BLCK_SLAB_CLASSES_HOST 8     //max number of size classes of sub-entries carved out of the lowest-level Host argument buffer entries (MEM_ALIGN*2^k bytes)
 //GPU argument buffer structure (the total number of entries must be less or equal to MAX_GPU_ARGS):
 #define BLCK_BUF_DEPTH_GPU 6         //number of distinct tensor block buffer levels on GPU
 #define BLCK_BUF_TOP_GPU 3           //number of argument buffer entries of the largest size (level 0) on GPU: multiple of 3
@@ -64,6 +71,37 @@ typedef struct{
  int buf_depth;  //number of levels
  int buf_branch; //branching factor for each subsequent level
 } ab_conf_t;
+// Shard of the cache of the lowest-level argument buffer entries (reserved in the occupancy table, but not in use):
+typedef struct alignas(GPU_CACHE_LINE_LEN){
+ omp_lock_t lock;                         //shard lock (never held while acquiring the global lock)
+ int num_entries;                         //number of cached entries
+ int entry_num[BLCK_CACHE_DEPTH_HOST];    //cached buffer entry numbers
+ char * entry_ptr[BLCK_CACHE_DEPTH_HOST]; //cached buffer entry pointers
+} ab_cache_t;
+// Allocation statistics of an argument buffer (Host statistics are sharded like the entry cache and guarded by the shard locks):
+typedef struct alignas(GPU_CACHE_LINE_LEN){
+ long long num_requests;                            //number of allocation requests
+ long long num_try_later;                           //number of allocation requests rejected with TRY_LATER
+ long long num_device_unable;                       //number of allocation requests rejected with DEVICE_UNABLE
+ long long requested_bytes;                         //total size of all satisfied allocation requests
+ long long granted_bytes;                           //total size of all granted buffer entries
+ long long requested_hist[MEM_TELEMETRY_HIST_BINS]; //histogram of requested sizes
+ long long granted_hist[MEM_TELEMETRY_HIST_BINS];   //histogram of granted buffer entry sizes
+} ab_stats_t;
+// Slab of sub-entries carved out of a lowest-level argument buffer entry:
+typedef struct{
+ slab_t slab;    //slab on top of the lowest-level buffer entry
+ int size_class; //size class of the slab (-1: the lowest-level buffer entry does not host a slab)
+ int listed;     //non-zero if the slab is on the list of slabs with free sub-entries of its size class
+} ab_slab_t;
+// Size class of the sub-entries carved out of the lowest-level argument buffer entries:
+typedef struct{
+ omp_lock_t lock;  //size class lock (never held while waiting for the global lock)
+ size_t entry_size; //sub-entry size in bytes (multiple of MEM_ALIGN)
+ int num_slabs;    //number of slabs of the size class
+ int num_partial;  //number of slabs with free sub-entries
+ int * partial;    //stack of slabs with free sub-entries (lowest-level buffer entry offsets)
+} ab_slab_class_t;
 
 //MODULE DATA:
 // Buffer memory management:
@@ -86,12 +124,23 @@ static size_t *abg_occ[MAX_GPUS_PER_NODE]; //occupation status for each buffer e
 static size_t abh_occ_size=0; //total number of entries in the multi-level Host argument buffer occupancy table
 static size_t abg_occ_size[MAX_GPUS_PER_NODE]; //total numbers of entries in the multi-level GPUs argument buffer occupancy tables
 // Buffer memory status:
-static int num_args_host=0; //number of occupied entries in the Host argument buffer
+static std::atomic<int> num_args_host(0); //number of occupied entries in the Host argument buffer (updated outside the global lock)
 static int num_args_gpu[MAX_GPUS_PER_NODE]={0}; //number of occupied entries in each GPU argument buffer
-static size_t occ_size_host=0; //total size (bytes) of all occupied entries in the Host argument buffer
+static std::atomic<size_t> occ_size_host(0); //total size (bytes) of all occupied entries in the Host argument buffer (updated outside the global lock)
 static size_t occ_size_gpu[MAX_GPUS_PER_NODE]={0}; //total size (bytes) of all occupied entries in each GPU buffer
 static size_t args_size_host=0; //total size (bytes) of all arguments in the Host argument buffer !`Not used now
 static size_t args_size_gpu[MAX_GPUS_PER_NODE]={0}; //total size (bytes) of all arguments in each GPU buffer !`Not used now
+static ab_stats_t abh_stats[BLCK_CACHE_SHARDS_HOST]; //allocation statistics of the Host argument buffer (one per cache shard)
+#ifndef NO_GPU
+static ab_stats_t abg_stats[MAX_GPUS_PER_NODE]; //allocation statistics of each GPU argument buffer
+#endif /*NO_GPU*/
+// Sharded cache of the lowest-level Host argument buffer entries (served without the global lock):
+static ab_cache_t abh_cache[BLCK_CACHE_SHARDS_HOST]; //shards (each thread sticks to one shard)
+static int abh_cache_next_shard=0; //next shard to be assigned to a thread
+// Size-class slabs for small Host argument buffer requests (sub-entry handle = abh_occ_size + byte offset / MEM_ALIGN):
+static ab_slab_class_t abh_slab_class[BLCK_SLAB_CLASSES_HOST]; //size classes in the order of increasing sub-entry size
+static int abh_slab_classes=0; //number of active size classes
+static ab_slab_t *abh_slab=NULL; //slab hosted by each lowest-level buffer entry
 // Slab for multi-index storage (pinned Host memory):
 static int miBank[MAX_GPU_ARGS*MAX_MLNDS_PER_TENS][MAX_TENSOR_RANK]; //All active .dims[], .divs[], .grps[], .prmn[] will be stored here
 static int miFreeHandle[MAX_GPU_ARGS*MAX_MLNDS_PER_TENS]; //free entries for storing multi-indices
@@ -108,6 +157,16 @@ static int get_buf_entry(ab_conf_t ab_conf, size_t bsize, void *arg_buf_ptr, siz
                          const size_t *blck_sizes, char **entry_ptr, int *entry_num);
 static int free_buf_entry(ab_conf_t ab_conf, size_t *ab_occ, size_t ab_occ_size, const size_t *blck_sizes, int entry_num);
 static void ab_conf_print(ab_conf_t ab_conf);
+static int abh_cache_shard();
+static int abh_cache_drain();
+static int abh_slab_get(size_t bsize, char **entry_ptr, int *entry_num);
+static int abh_slab_release(int entry_num);
+static int abh_slab_trim();
+static int abh_slab_from_address(const void *addr);
+static int abh_get_entry(size_t bsize, char **entry_ptr, int *entry_num);
+static void ab_stats_record(ab_stats_t *stats, size_t bsize, size_t granted, int err_code);
+static int ab_get_telemetry(ab_conf_t ab_conf, const size_t *ab_occ, const size_t *blck_sizes, size_t buf_size,
+                            mem_telemetry_t *telemetry);
 static int mi_entry_init();
 static int mi_entry_stop();
 //------------------------------------------------------------------------------------------------------------------------
@@ -241,6 +300,24 @@ OUTPUT:
   abh_occ_size=hsize;
   for(hsize=0;hsize<abh_occ_size;hsize++){abh_occ[hsize]=0;} //initialize zero occupancy for each buffer entry
   num_args_host=0; occ_size_host=0; args_size_host=0; //clear Host memory statistics
+  for(i=0;i<BLCK_CACHE_SHARDS_HOST;i++) abh_stats[i]=ab_stats_t{};
+//Initialize the cache of the lowest-level Host argument buffer entries:
+  for(i=0;i<BLCK_CACHE_SHARDS_HOST;i++){omp_init_lock(&(abh_cache[i].lock)); abh_cache[i].num_entries=0;}
+//Initialize the size classes of sub-entries (at least two sub-entries per lowest-level entry):
+  abh_slab_classes=0;
+  if(abh_occ_size+arg_buf_host_size/MEM_ALIGN <= (size_t)INT_MAX){ //sub-entry handles must be representable
+   abh_slab=(ab_slab_t*)malloc(max_args_host*sizeof(ab_slab_t)); if(abh_slab == NULL) return 4;
+   for(i=0;i<max_args_host;i++){slab_clean(&(abh_slab[i].slab)); abh_slab[i].size_class=-1; abh_slab[i].listed=0;}
+   while(abh_slab_classes < BLCK_SLAB_CLASSES_HOST &&
+         (((size_t)MEM_ALIGN)<<(abh_slab_classes+1)) <= blck_sizes_host[BLCK_BUF_DEPTH_HOST-1]){
+    abh_slab_class[abh_slab_classes].partial=(int*)malloc(max_args_host*sizeof(int));
+    if(abh_slab_class[abh_slab_classes].partial == NULL) return 5;
+    abh_slab_class[abh_slab_classes].entry_size=((size_t)MEM_ALIGN)<<abh_slab_classes;
+    abh_slab_class[abh_slab_classes].num_slabs=0; abh_slab_class[abh_slab_classes].num_partial=0;
+    omp_init_lock(&(abh_slab_class[abh_slab_classes].lock));
+    ++abh_slab_classes;
+   }
+  }
 //Initialize the multi-index entry bank (slab) in pinned Host memory:
   err_code=mi_entry_init(); if(err_code) return 3;
 #ifndef NO_GPU
@@ -294,6 +371,7 @@ OUTPUT:
        abg_occ_size[i]=hsize;
        for(hsize=0;hsize<abg_occ_size[i];hsize++){abg_occ[i][hsize]=0;} //initialize each buffer entry to zero occupancy
        num_args_gpu[i]=0; occ_size_gpu[i]=0; args_size_gpu[i]=0; //clear GPU memory statistics
+       abg_stats[i]=ab_stats_t{};
       }else{
        return 13;
       }
@@ -326,6 +404,16 @@ int arg_buf_deallocate(int gpu_beg, int gpu_end)
  omp_set_nest_lock(&mem_lock);
 #pragma omp flush
  err_code=0;
+ for(i=0;i<BLCK_CACHE_SHARDS_HOST;i++){abh_cache[i].num_entries=0; omp_destroy_lock(&(abh_cache[i].lock));}
+ for(i=0;i<abh_slab_classes;i++){
+  free(abh_slab_class[i].partial); abh_slab_class[i].partial=NULL;
+  abh_slab_class[i].num_slabs=0; abh_slab_class[i].num_partial=0; omp_destroy_lock(&(abh_slab_class[i].lock));
+ }
+ abh_slab_classes=0;
+ if(abh_slab != NULL){
+  for(i=0;i<max_args_host;i++){if(abh_slab[i].size_class >= 0) slab_destruct(&(abh_slab[i].slab));}
+  free(abh_slab); abh_slab=NULL;
+ }
  if(abh_occ != NULL) free(abh_occ); abh_occ=NULL; abh_occ_size=0; max_args_host=0;
  for(i=0;i<MAX_GPUS_PER_NODE;i++){
   if(abg_occ[i] != NULL) free(abg_occ[i]); abg_occ[i]=NULL; abg_occ_size[i]=0; max_args_gpu[i]=0;
@@ -378,6 +466,8 @@ Negative return status means that an error occurred. **/
  omp_set_nest_lock(&mem_lock);
 #pragma omp flush
  if(bufs_ready == 0){omp_unset_nest_lock(&mem_lock); return -1;} //memory buffers are not initialized
+ if(abh_slab_trim() != 0){omp_unset_nest_lock(&mem_lock); return -3;} //empty slabs are free
+ if(abh_cache_drain() != 0){omp_unset_nest_lock(&mem_lock); return -2;} //cached entries are free
  for(size_t i=0;i<abh_occ_size;i++){
   if(abh_occ[i] != 0){omp_unset_nest_lock(&mem_lock); return (int)(i+1);}
  }
@@ -595,8 +685,182 @@ static int free_buf_entry(ab_conf_t ab_conf, size_t *ab_occ, size_t ab_occ_size,
  return 0;
 }
 
+static int abh_cache_shard()
+/** Returns the shard of the Host argument buffer entry cache assigned to the current thread.
+Threads are assigned to shards in a round-robin fashion upon their first request. **/
+{
+ static thread_local int shard=-1;
+ if(shard < 0){
+#pragma omp atomic capture
+  shard=abh_cache_next_shard++;
+  shard%=BLCK_CACHE_SHARDS_HOST;
+ }
+ return shard;
+}
+
+static int abh_cache_drain()
+/** Returns all cached lowest-level entries of all shards back to the Host argument buffer. **/
+{
+ int i,n,err_code,entries[BLCK_CACHE_DEPTH_HOST];
+ ab_conf_t ab_conf;
+
+ err_code=0;
+ ab_conf.buf_top=BLCK_BUF_TOP_HOST; ab_conf.buf_depth=BLCK_BUF_DEPTH_HOST; ab_conf.buf_branch=BLCK_BUF_BRANCH_HOST;
+ for(int shard=0;shard<BLCK_CACHE_SHARDS_HOST;shard++){
+  omp_set_lock(&(abh_cache[shard].lock));
+  n=abh_cache[shard].num_entries; abh_cache[shard].num_entries=0;
+  for(i=0;i<n;i++) entries[i]=abh_cache[shard].entry_num[i];
+  omp_unset_lock(&(abh_cache[shard].lock));
+  for(i=0;i<n;i++){
+   if(free_buf_entry(ab_conf,abh_occ,abh_occ_size,blck_sizes_host,entries[i]) != 0) err_code=1;
+  }
+ }
+ return err_code;
+}
+
+static int abh_slab_get(size_t bsize, char **entry_ptr, int *entry_num)
+/** Serves a small request from a slab of the smallest fitting size class. A new slab
+(one lowest-level buffer entry) is added to the size class when all its slabs are full.
+Returns a positive status if the request cannot be served by the slabs, but can be tried regularly. **/
+{
+ int c,j,err_code,backing;
+ void *ptr;
+ char *bptr;
+ slab_t slab;
+ ab_slab_class_t *sc;
+
+ for(c=0;c<abh_slab_classes;c++){if(bsize <= abh_slab_class[c].entry_size) break;}
+ if(c >= abh_slab_classes) return 1;
+ sc=&(abh_slab_class[c]); ptr=NULL;
+//Try the slabs with free sub-entries:
+ omp_set_lock(&(sc->lock));
+ if(sc->num_partial > 0){
+  j=sc->partial[sc->num_partial-1];
+  err_code=slab_entry_get(&(abh_slab[j].slab),&ptr); if(err_code != 0) ptr=NULL;
+  if(abh_slab[j].slab.first_free == abh_slab[j].slab.max_entries){abh_slab[j].listed=0; sc->num_partial--;} //slab is full
+ }
+ omp_unset_lock(&(sc->lock));
+//Add a new slab carved out of a lowest-level buffer entry (the size class lock must not be held here):
+ if(ptr == NULL){
+  err_code=abh_get_entry(blck_sizes_host[BLCK_BUF_DEPTH_HOST-1],&bptr,&backing); if(err_code != 0) return err_code;
+  slab_clean(&slab);
+  err_code=slab_construct_ext(&slab,sc->entry_size,blck_sizes_host[BLCK_BUF_DEPTH_HOST-1]/(sc->entry_size),(void*)bptr,MEM_ALIGN);
+  if(err_code != 0){free_buf_entry_host(backing); return 2;}
+  slab_entry_get(&slab,&ptr);
+  j=(int)(((size_t)(bptr-(char*)arg_buf_host))/blck_sizes_host[BLCK_BUF_DEPTH_HOST-1]);
+  omp_set_lock(&(sc->lock));
+  abh_slab[j].slab=slab; abh_slab[j].listed=1;
+  sc->partial[sc->num_partial++]=j; sc->num_slabs++;
+#pragma omp atomic write
+  abh_slab[j].size_class=c;
+  omp_unset_lock(&(sc->lock));
+ }
+ *entry_ptr=(char*)ptr;
+ *entry_num=(int)(abh_occ_size+((size_t)((char*)ptr-(char*)arg_buf_host))/MEM_ALIGN);
+ if(LOGGING){
+  printf("\n#DEBUG(TALSH:mem_manager): Host Buffer alloc %lu B -> Entry %d (slab)\n",bsize,*entry_num);
+  fflush(stdout);
+ }
+ return 0;
+}
+
+static int abh_slab_release(int entry_num)
+/** Releases a sub-entry previously served by abh_slab_get(). A slab which becomes empty
+is returned to the buffer, unless it is the last slab of its size class. **/
+{
+ int c,j,k,err_code;
+ size_t offset;
+ void *ptr;
+ slab_t slab;
+ ab_slab_class_t *sc;
+
+ offset=((size_t)(entry_num-(int)abh_occ_size))*MEM_ALIGN;
+ if(entry_num < (int)abh_occ_size || offset >= arg_buf_host_size) return 1;
+ j=(int)(offset/blck_sizes_host[BLCK_BUF_DEPTH_HOST-1]); ptr=(void*)(&(((char*)arg_buf_host)[offset]));
+#pragma omp atomic read
+ c=abh_slab[j].size_class;
+ if(c < 0) return 2; //no slab there
+ sc=&(abh_slab_class[c]); slab_clean(&slab);
+ omp_set_lock(&(sc->lock));
+ err_code=slab_entry_release(&(abh_slab[j].slab),ptr);
+ if(err_code == 0){
+  if(abh_slab[j].listed == 0){abh_slab[j].listed=1; sc->partial[sc->num_partial++]=j;} //slab is no longer full
+  if(abh_slab[j].slab.first_free == 0 && sc->num_slabs > 1){ //detach the empty slab
+   for(k=sc->num_partial-1;k>=0;k--){if(sc->partial[k] == j) break;}
+   sc->partial[k]=sc->partial[--(sc->num_partial)]; sc->num_slabs--;
+   slab=abh_slab[j].slab; slab_clean(&(abh_slab[j].slab)); abh_slab[j].listed=0;
+#pragma omp atomic write
+   abh_slab[j].size_class=-1;
+  }
+ }
+ omp_unset_lock(&(sc->lock));
+ if(slab.slab_base != NULL){
+  slab_destruct(&slab);
+  if(free_buf_entry_host(ab_get_1d_pos(ab_conf_host,BLCK_BUF_DEPTH_HOST-1,j)) != 0) err_code=3;
+ }
+ if(LOGGING && err_code == 0){
+  printf("\n#DEBUG(TALSH:mem_manager): Host Buffer free -> Entry %d (slab)\n",entry_num);
+  fflush(stdout);
+ }
+ return err_code;
+}
+
+static int abh_slab_trim()
+/** Returns all empty slabs of all size classes back to the Host argument buffer. **/
+{
+ int c,j,k,n,err_code;
+ ab_slab_class_t *sc;
+
+ err_code=0;
+ for(c=0;c<abh_slab_classes;c++){
+  sc=&(abh_slab_class[c]);
+  omp_set_lock(&(sc->lock));
+  n=0; //number of detached slabs (their offsets are moved beyond the end of the stack)
+  for(k=sc->num_partial-1;k>=0;k--){
+   j=sc->partial[k];
+   if(abh_slab[j].slab.first_free == 0){
+    slab_destruct(&(abh_slab[j].slab)); abh_slab[j].listed=0;
+#pragma omp atomic write
+    abh_slab[j].size_class=-1;
+    sc->partial[k]=sc->partial[sc->num_partial-1]; sc->partial[sc->num_partial-1]=j;
+    sc->num_partial--; sc->num_slabs--; ++n;
+   }
+  }
+  for(k=sc->num_partial;k<sc->num_partial+n;k++){
+   if(free_buf_entry_host(ab_get_1d_pos(ab_conf_host,BLCK_BUF_DEPTH_HOST-1,sc->partial[k])) != 0) err_code=1;
+  }
+  omp_unset_lock(&(sc->lock));
+ }
+ return err_code;
+}
+
+static int abh_slab_from_address(const void *addr)
+/** Returns the handle of the slab sub-entry starting at a given address,
+-1 if the address does not belong to any slab, or -5 if it is misaligned.
+A live sub-entry pins its slab, thus no size class lock is needed here. **/
+{
+ int c;
+ size_t offset;
+
+ if(abh_slab_classes == 0) return -1;
+ if((size_t)((const char*)(addr)) < (size_t)((const char*)(arg_buf_host))) return -1;
+ offset=(size_t)(((const char*)(addr))-((const char*)(arg_buf_host)));
+ if(offset >= arg_buf_host_size) return -1;
+#pragma omp atomic read
+ c=abh_slab[offset/blck_sizes_host[BLCK_BUF_DEPTH_HOST-1]].size_class;
+ if(c < 0) return -1;
+ if((offset%blck_sizes_host[BLCK_BUF_DEPTH_HOST-1])%(abh_slab_class[c].entry_size) != 0) return -5;
+ return (int)(abh_occ_size+offset/MEM_ALIGN);
+}
+
 int get_buf_entry_host(size_t bsize, char **entry_ptr, int *entry_num)
 /** This function returns a pointer to a free argument buffer space in the Host argument buffer.
+Requests not exceeding half of the lowest-level buffer entry are served from the slabs of
+the smallest fitting size class (sub-entries of MEM_ALIGN*2^k bytes carved out of the
+lowest-level buffer entries). Requests fitting into the lowest-level buffer entries are
+served from the cache shard of the calling thread without acquiring the global lock
+(an empty shard is refilled with a batch of lowest-level entries taken from the buffer
+under the global lock).
 INPUT:
  # bsize - requested size of a tensor block (in bytes);
 OUTPUT:
@@ -610,22 +874,107 @@ RETURN STATUS:
 **/
 {
  int i,j,err_code;
+ size_t granted;
+
+ err_code=abh_get_entry(bsize,entry_ptr,entry_num);
+ granted=0;
+ if(err_code == 0){
+  if(*entry_num >= (int)abh_occ_size){ //slab sub-entry
+#pragma omp atomic read
+   j=abh_slab[((size_t)(*entry_num-(int)abh_occ_size))*MEM_ALIGN/blck_sizes_host[BLCK_BUF_DEPTH_HOST-1]].size_class;
+   if(j >= 0) granted=abh_slab_class[j].entry_size;
+  }else{
+   if(ab_get_2d_pos(ab_conf_host,*entry_num,&i,&j) == 0) granted=blck_sizes_host[i];
+  }
+ }
+ i=abh_cache_shard();
+ omp_set_lock(&(abh_cache[i].lock)); //Host statistics of a shard are guarded by its lock
+ ab_stats_record(&(abh_stats[i]),bsize,granted,err_code);
+ omp_unset_lock(&(abh_cache[i].lock));
+ return err_code;
+}
+
+static int abh_get_entry(size_t bsize, char **entry_ptr, int *entry_num)
+/** Implements get_buf_entry_host() (without the allocation statistics). **/
+{
+ int i,j,n,shard,err_code,entries[BLCK_CACHE_REFILL_HOST];
+ char *ptrs[BLCK_CACHE_REFILL_HOST];
  ab_conf_t ab_conf;
 
+#pragma omp flush
+ if(bufs_ready == 0) return -1;
+ *entry_ptr=NULL; *entry_num=-1;
+ ab_conf.buf_top=BLCK_BUF_TOP_HOST; ab_conf.buf_depth=BLCK_BUF_DEPTH_HOST; ab_conf.buf_branch=BLCK_BUF_BRANCH_HOST;
+//Small requests are served from the slabs:
+ if(abh_slab_classes > 0 && bsize <= abh_slab_class[abh_slab_classes-1].entry_size){
+  err_code=abh_slab_get(bsize,entry_ptr,entry_num);
+  if(err_code <= 0) return err_code;
+  *entry_ptr=NULL; *entry_num=-1;
+ }
+//Lowest-level entries are served from the cache shard of the current thread:
+ if(bsize <= blck_sizes_host[BLCK_BUF_DEPTH_HOST-1]){
+  shard=abh_cache_shard();
+  omp_set_lock(&(abh_cache[shard].lock));
+  n=abh_cache[shard].num_entries;
+  if(n > 0){
+   --n; *entry_num=abh_cache[shard].entry_num[n]; *entry_ptr=abh_cache[shard].entry_ptr[n];
+   abh_cache[shard].num_entries=n;
+  }
+  omp_unset_lock(&(abh_cache[shard].lock));
+  if(*entry_num < 0){ //refill the shard from the buffer (the shard lock must not be held here)
+   n=0;
+   omp_set_nest_lock(&mem_lock);
+#pragma omp flush
+   while(n < BLCK_CACHE_REFILL_HOST){
+    if(get_buf_entry(ab_conf,bsize,arg_buf_host,abh_occ,abh_occ_size,blck_sizes_host,&(ptrs[n]),&(entries[n])) != 0) break;
+    ++n;
+   }
+#pragma omp flush
+   omp_unset_nest_lock(&mem_lock);
+   if(n > 0){
+    --n; *entry_num=entries[n]; *entry_ptr=ptrs[n];
+    omp_set_lock(&(abh_cache[shard].lock));
+    while(n > 0 && abh_cache[shard].num_entries < BLCK_CACHE_DEPTH_HOST){
+     --n; j=abh_cache[shard].num_entries++;
+     abh_cache[shard].entry_num[j]=entries[n]; abh_cache[shard].entry_ptr[j]=ptrs[n];
+    }
+    omp_unset_lock(&(abh_cache[shard].lock));
+    while(n > 0){ //shard has been refilled by another thread in the meantime
+     --n; free_buf_entry(ab_conf,abh_occ,abh_occ_size,blck_sizes_host,entries[n]);
+    }
+   }
+  }
+  if(*entry_num >= 0){
+   num_args_host.fetch_add(1);
+   occ_size_host.fetch_add(blck_sizes_host[BLCK_BUF_DEPTH_HOST-1]);
+   if(LOGGING){
+    printf("\n#DEBUG(TALSH:mem_manager): Host Buffer alloc %lu B -> Entry %d (cached)\n",bsize,*entry_num);
+    fflush(stdout);
+   }
+   return 0;
+  }
+ }
+//Other entries are taken from the buffer under the global lock:
  omp_set_nest_lock(&mem_lock);
 #pragma omp flush
  if(bufs_ready == 0){omp_unset_nest_lock(&mem_lock); return -1;}
  err_code=0;
- ab_conf.buf_top=BLCK_BUF_TOP_HOST; ab_conf.buf_depth=BLCK_BUF_DEPTH_HOST; ab_conf.buf_branch=BLCK_BUF_BRANCH_HOST;
  //if(DEBUG) printf("\n#DEBUG(mem_manager:get_buf_entry_host): Allocating buffer entry for size %lu: ",bsize); //debug
  err_code=get_buf_entry(ab_conf,bsize,arg_buf_host,abh_occ,abh_occ_size,blck_sizes_host,entry_ptr,entry_num);
+ if(err_code == TRY_LATER){ //cached lowest-level entries may fragment the buffer: return them and retry
+  if(abh_cache_drain() == 0) err_code=get_buf_entry(ab_conf,bsize,arg_buf_host,abh_occ,abh_occ_size,blck_sizes_host,entry_ptr,entry_num);
+ }
  //if(DEBUG) printf("Status %d: Buffer entry %d: Address %p\n",err_code,*entry_num,*entry_ptr); //debug
  if(err_code == 0){
   err_code=ab_get_2d_pos(ab_conf,*entry_num,&i,&j);
-  if(err_code == 0){num_args_host++; occ_size_host+=blck_sizes_host[i]; args_size_host+=bsize;}
+  if(err_code == 0){
+   num_args_host.fetch_add(1);
+   occ_size_host.fetch_add(blck_sizes_host[i]);
+   args_size_host+=bsize;
+  }
  }
  if(LOGGING && err_code == 0){
-  printf("\n#DEBUG(TALSH:mem_manager): Host Buffer alloc %lu B -> Entry %d: Buffer use = %lu B\n",bsize,*entry_num,occ_size_host);
+  printf("\n#DEBUG(TALSH:mem_manager): Host Buffer alloc %lu B -> Entry %d: Buffer use = %lu B\n",bsize,*entry_num,occ_size_host.load());
   fflush(stdout);
  }
 #pragma omp flush
@@ -635,27 +984,54 @@ RETURN STATUS:
 
 int free_buf_entry_host(int entry_num)
 /** This function releases a Host argument buffer entry.
+A slab sub-entry is returned into its slab. A lowest-level entry is
+returned into the cache shard of the calling thread (without acquiring
+the global lock), unless the shard is full.
 INPUT:
  # entry_num - argument buffer entry number.
 **/
 {
- int i,j,err_code;
+ int i,j,shard,err_code;
  ab_conf_t ab_conf;
 
+#pragma omp flush
+ if(bufs_ready == 0) return -1;
+ if(entry_num >= (int)abh_occ_size) return abh_slab_release(entry_num);
+ ab_conf.buf_top=BLCK_BUF_TOP_HOST; ab_conf.buf_depth=BLCK_BUF_DEPTH_HOST; ab_conf.buf_branch=BLCK_BUF_BRANCH_HOST;
+ err_code=ab_get_2d_pos(ab_conf,entry_num,&i,&j); if(err_code != 0) return 1;
+//Lowest-level entries are returned into the cache shard of the current thread:
+ if(i == BLCK_BUF_DEPTH_HOST-1){
+  shard=abh_cache_shard();
+  omp_set_lock(&(abh_cache[shard].lock));
+  if(abh_cache[shard].num_entries < BLCK_CACHE_DEPTH_HOST){
+   abh_cache[shard].entry_ptr[abh_cache[shard].num_entries]=&(((char*)arg_buf_host)[ab_get_offset(ab_conf,i,j,blck_sizes_host)]);
+   abh_cache[shard].entry_num[abh_cache[shard].num_entries++]=entry_num;
+   omp_unset_lock(&(abh_cache[shard].lock));
+   num_args_host.fetch_sub(1);
+   occ_size_host.fetch_sub(blck_sizes_host[i]);
+   if(LOGGING){
+    printf("\n#DEBUG(TALSH:mem_manager): Host Buffer free -> Entry %d (cached)\n",entry_num);
+    fflush(stdout);
+   }
+   return 0;
+  }
+  omp_unset_lock(&(abh_cache[shard].lock));
+ }
+//Other entries are returned into the buffer under the global lock:
  omp_set_nest_lock(&mem_lock);
 #pragma omp flush
  if(bufs_ready == 0){omp_unset_nest_lock(&mem_lock); return -1;}
  err_code=0;
- ab_conf.buf_top=BLCK_BUF_TOP_HOST; ab_conf.buf_depth=BLCK_BUF_DEPTH_HOST; ab_conf.buf_branch=BLCK_BUF_BRANCH_HOST;
  //if(DEBUG) printf("\n#DEBUG(mem_manager:free_buf_entry_host): Deallocating buffer entry %d: ",entry_num); //debug
  err_code=free_buf_entry(ab_conf,abh_occ,abh_occ_size,blck_sizes_host,entry_num);
  //if(DEBUG) printf("Status %d\n",err_code); //debug
  if(err_code == 0){
-  err_code=ab_get_2d_pos(ab_conf,entry_num,&i,&j);
-  if(err_code == 0){num_args_host--; occ_size_host-=blck_sizes_host[i]; args_size_host=0;} //`args_size_host is not used (ignore it)
+  num_args_host.fetch_sub(1);
+  occ_size_host.fetch_sub(blck_sizes_host[i]);
+  args_size_host=0; //`args_size_host is not used (ignore it)
  }
  if(LOGGING && err_code == 0){
-  printf("\n#DEBUG(TALSH:mem_manager): Host Buffer free -> Entry %d: Buffer use = %lu B\n",entry_num,occ_size_host);
+  printf("\n#DEBUG(TALSH:mem_manager): Host Buffer free -> Entry %d: Buffer use = %lu B\n",entry_num,occ_size_host.load());
   fflush(stdout);
  }
 #pragma omp flush
@@ -694,6 +1070,9 @@ RETURN STATUS:
    if(err_code == 0){
     err_code=ab_get_2d_pos(ab_conf,*entry_num,&i,&j);
     if(err_code == 0){num_args_gpu[gpu_num]++; occ_size_gpu[gpu_num]+=blck_sizes_gpu[gpu_num][i]; args_size_gpu[gpu_num]+=bsize;}
+    ab_stats_record(&(abg_stats[gpu_num]),bsize,blck_sizes_gpu[gpu_num][i],err_code);
+   }else{
+    ab_stats_record(&(abg_stats[gpu_num]),bsize,0,err_code);
    }
    if(LOGGING && err_code == 0){
     printf("\n#DEBUG(TALSH:mem_manager): GPU %d Buffer alloc %lu B -> Entry %d: Buffer use = %lu B\n",gpu_num,bsize,*entry_num,occ_size_gpu[gpu_num]);
@@ -844,6 +1223,7 @@ int get_buf_entry_from_address(int dev_id, const void * addr)
  dev_num=decode_device_id(dev_id,&dev_kind); if(dev_num < 0){omp_unset_nest_lock(&mem_lock); return -2;} //invalid device id
  switch(dev_kind){
   case DEV_HOST:
+   i=abh_slab_from_address(addr); if(i != -1){omp_unset_nest_lock(&mem_lock); return i;} //slab sub-entry
    if((size_t)((const char*)(addr)) >= (size_t)((const char*)(arg_buf_host))){
     ab_conf=&ab_conf_host;
     buf_size=arg_buf_host_size;
@@ -913,6 +1293,178 @@ int get_buf_entry_from_address(int dev_id, const void * addr)
  return ben; //flat buffer entry number [0..MAX], or -1 (not in buffer), or negative error code
 }
 
+static void ab_stats_record(ab_stats_t *stats, size_t bsize, size_t granted, int err_code)
+/** Records an allocation request in the allocation statistics of an argument buffer
+(the caller must hold the lock guarding the statistics). **/
+{
+ int k;
+ size_t sz;
+
+ k=0; sz=bsize; while(sz > 1 && k < MEM_TELEMETRY_HIST_BINS-1){sz>>=1; ++k;}
+ stats->num_requests++; stats->requested_hist[k]++;
+ if(err_code == 0){
+  k=0; sz=granted; while(sz > 1 && k < MEM_TELEMETRY_HIST_BINS-1){sz>>=1; ++k;}
+  stats->requested_bytes+=bsize; stats->granted_bytes+=granted; stats->granted_hist[k]++;
+ }else if(err_code == TRY_LATER){
+  stats->num_try_later++;
+ }else if(err_code == DEVICE_UNABLE){
+  stats->num_device_unable++;
+ }
+ return;
+}
+
+static int ab_get_telemetry(ab_conf_t ab_conf, const size_t *ab_occ, const size_t *blck_sizes, size_t buf_size,
+                            mem_telemetry_t *telemetry)
+/** Analyzes the occupancy table of an argument buffer (the global lock must be held by the caller).
+An entry is occupied as a whole if it is fully occupied while none of its children is occupied.
+A maximal free entry is a free entry whose parent is not free (it can be allocated as a whole). **/
+{
+ int i,j,k,l,m,n,nused,nfree;
+ char *prev,*curr,*cov;
+
+ n=ab_conf.buf_top; for(i=1;i<ab_conf.buf_depth;i++) n*=ab_conf.buf_branch; //number of the lowest-level entries
+ prev=(char*)malloc(n); curr=(char*)malloc(n); //non-zero: entry is inside an entry occupied as a whole or a free entry
+ if(prev == NULL || curr == NULL){if(prev != NULL) free(prev); if(curr != NULL) free(curr); return 1;}
+ telemetry->buf_size=buf_size; telemetry->occ_size=0; telemetry->largest_free=0;
+ telemetry->num_levels=MIN(ab_conf.buf_depth,MEM_TELEMETRY_MAX_LEVELS);
+ n=ab_conf.buf_top;
+ for(i=0;i<ab_conf.buf_depth;i++){
+  if(i > 0) n*=ab_conf.buf_branch;
+  nused=0; nfree=0;
+  for(j=0;j<n;j++){
+   m=ab_get_1d_pos(ab_conf,i,j);
+   if(i == 0) telemetry->occ_size+=ab_occ[m];
+   if(i > 0){if(prev[j/ab_conf.buf_branch] != 0){curr[j]=1; continue;}}
+   curr[j]=0;
+   if(ab_occ[m] == 0){
+    ++nfree; curr[j]=1;
+   }else if(ab_occ[m] == blck_sizes[i]){
+    curr[j]=1;
+    if(i < ab_conf.buf_depth-1){
+     k=ab_get_1d_pos(ab_conf,i+1,j*ab_conf.buf_branch);
+     for(l=0;l<ab_conf.buf_branch;l++){if(ab_occ[k+l] != 0){curr[j]=0; break;}}
+    }
+    if(curr[j] != 0) ++nused;
+   }
+  }
+  if(i < MEM_TELEMETRY_MAX_LEVELS){
+   telemetry->level_size[i]=blck_sizes[i]; telemetry->level_entries[i]=n;
+   telemetry->level_used[i]=nused; telemetry->level_free[i]=nfree;
+  }
+  if(nfree > 0 && telemetry->largest_free == 0) telemetry->largest_free=blck_sizes[i];
+  cov=prev; prev=curr; curr=cov;
+ }
+ free(prev); free(curr);
+ if(telemetry->occ_size < buf_size){ //no entry can be larger than a top-level entry
+  telemetry->fragmentation=1.0-((double)(telemetry->largest_free))/((double)(MIN(buf_size-telemetry->occ_size,blck_sizes[0])));
+ }else{
+  telemetry->fragmentation=0.0;
+ }
+ return 0;
+}
+
+int mem_get_telemetry(int dev_id, mem_telemetry_t * telemetry)
+/** Returns the telemetry of the argument buffer of a given device: Occupancy of each buffer level,
+the largest allocatable entry, the fragmentation ratio, and the allocation statistics since
+the last reset (rejected requests, histograms of requested sizes and granted entry sizes). **/
+{
+ int i,j,k,devk,errc;
+ ab_stats_t *stats;
+
+ if(telemetry == NULL) return -4;
+ omp_set_nest_lock(&mem_lock);
+#pragma omp flush
+ if(bufs_ready == 0){omp_unset_nest_lock(&mem_lock); return -1;}
+ *telemetry=mem_telemetry_t{}; errc=0;
+ i=decode_device_id(dev_id,&devk);
+ if(i >= 0){
+  switch(devk){
+   case DEV_HOST:
+    errc=ab_get_telemetry(ab_conf_host,abh_occ,blck_sizes_host,arg_buf_host_size,telemetry);
+    for(j=0;j<BLCK_CACHE_SHARDS_HOST;j++){
+     omp_set_lock(&(abh_cache[j].lock)); telemetry->num_cached+=abh_cache[j].num_entries; omp_unset_lock(&(abh_cache[j].lock));
+    }
+    for(j=0;j<abh_slab_classes;j++) omp_set_lock(&(abh_slab_class[j].lock));
+    for(j=0;j<abh_slab_classes;j++) telemetry->num_slabs+=abh_slab_class[j].num_slabs;
+    if(abh_slab_classes > 0){
+     for(j=0;j<max_args_host;j++){if(abh_slab[j].size_class >= 0) telemetry->num_sub_entries+=(int)(abh_slab[j].slab.first_free);}
+    }
+    for(j=abh_slab_classes-1;j>=0;j--) omp_unset_lock(&(abh_slab_class[j].lock));
+    for(j=0;j<BLCK_CACHE_SHARDS_HOST;j++){
+     stats=&(abh_stats[j]);
+     omp_set_lock(&(abh_cache[j].lock));
+     telemetry->num_requests+=stats->num_requests;
+     telemetry->num_try_later+=stats->num_try_later;
+     telemetry->num_device_unable+=stats->num_device_unable;
+     telemetry->requested_bytes+=stats->requested_bytes;
+     telemetry->granted_bytes+=stats->granted_bytes;
+     for(k=0;k<MEM_TELEMETRY_HIST_BINS;k++){
+      telemetry->requested_hist[k]+=stats->requested_hist[k]; telemetry->granted_hist[k]+=stats->granted_hist[k];
+     }
+     omp_unset_lock(&(abh_cache[j].lock));
+    }
+    break;
+#ifndef NO_GPU
+   case DEV_NVIDIA_GPU:
+    if(gpu_is_mine(i) != GPU_OFF){
+     errc=ab_get_telemetry(ab_conf_gpu[i],abg_occ[i],&(blck_sizes_gpu[i][0]),arg_buf_gpu_size[i],telemetry);
+     stats=&(abg_stats[i]);
+     telemetry->num_requests=stats->num_requests;
+     telemetry->num_try_later=stats->num_try_later;
+     telemetry->num_device_unable=stats->num_device_unable;
+     telemetry->requested_bytes=stats->requested_bytes;
+     telemetry->granted_bytes=stats->granted_bytes;
+     for(k=0;k<MEM_TELEMETRY_HIST_BINS;k++){
+      telemetry->requested_hist[k]=stats->requested_hist[k]; telemetry->granted_hist[k]=stats->granted_hist[k];
+     }
+    }else{
+     errc=-5; //GPU is not in use
+    }
+    break;
+#endif /*NO_GPU*/
+   default:
+    errc=-2; //unsupported device kind
+  }
+ }else{
+  errc=-3; //invalid device id
+ }
+ omp_unset_nest_lock(&mem_lock);
+ return errc;
+}
+
+int mem_reset_telemetry(int dev_id)
+/** Resets the allocation statistics of the argument buffer of a given device. **/
+{
+ int i,j,devk,errc;
+
+ omp_set_nest_lock(&mem_lock);
+#pragma omp flush
+ if(bufs_ready == 0){omp_unset_nest_lock(&mem_lock); return -1;}
+ errc=0;
+ i=decode_device_id(dev_id,&devk);
+ if(i >= 0){
+  switch(devk){
+   case DEV_HOST:
+    for(j=0;j<BLCK_CACHE_SHARDS_HOST;j++){
+     omp_set_lock(&(abh_cache[j].lock)); abh_stats[j]=ab_stats_t{}; omp_unset_lock(&(abh_cache[j].lock));
+    }
+    break;
+#ifndef NO_GPU
+   case DEV_NVIDIA_GPU:
+    abg_stats[i]=ab_stats_t{};
+    break;
+#endif /*NO_GPU*/
+   default:
+    errc=-2; //unsupported device kind
+  }
+ }else{
+  errc=-3; //invalid device id
+ }
+#pragma omp flush
+ omp_unset_nest_lock(&mem_lock);
+ return errc;
+}
+
 void mem_log_start()
 {
  LOGGING=1;
@@ -937,7 +1489,7 @@ int mem_free_left(int dev_id, size_t * free_mem) //returns free buffer space in
  if(i >= 0){
   switch(devk){
    case DEV_HOST:
-    *free_mem=arg_buf_host_size-occ_size_host;
+    *free_mem=arg_buf_host_size-occ_size_host.load();
     break;
 #ifndef NO_GPU
    case DEV_NVIDIA_GPU:
@@ -966,6 +1518,7 @@ int mem_free_left(int dev_id, size_t * free_mem) //returns free buffer space in
 int mem_print_stats(int dev_id) //print memory statistics for Device <dev_id>
 {
  int i,devk;
+ mem_telemetry_t tlm;
 
  omp_set_nest_lock(&mem_lock);
 #pragma omp flush
@@ -977,9 +1530,16 @@ int mem_print_stats(int dev_id) //print memory statistics for Device <dev_id>
     printf("\nTAL-SH: Host argument buffer usage state:\n");
     printf(" Total buffer size (bytes)       : %lu\n",arg_buf_host_size);
     printf(" Total number of entries         : %d\n",max_args_host);
-    printf(" Number of occupied entries      : %d\n",num_args_host);
-    printf(" Size of occupied entries (bytes): %lu\n",occ_size_host);
+    printf(" Number of occupied entries      : %d\n",num_args_host.load());
+    printf(" Size of occupied entries (bytes): %lu\n",occ_size_host.load());
 //  printf(" Size of all arguments (bytes)   : %lu\n",args_size_host);
+    if(mem_get_telemetry(dev_id,&tlm) == 0){
+     printf(" Largest free entry (bytes)      : %lu\n",tlm.largest_free);
+     printf(" Fragmentation ratio             : %f\n",tlm.fragmentation);
+     printf(" Slabs (sub-entries in use)      : %d (%d)\n",tlm.num_slabs,tlm.num_sub_entries);
+     printf(" Requests (TRY_LATER/DEV_UNABLE) : %lld (%lld/%lld)\n",tlm.num_requests,tlm.num_try_later,tlm.num_device_unable);
+     printf(" Requested/granted size (bytes)  : %lld/%lld\n",tlm.requested_bytes,tlm.granted_bytes);
+    }
     break;
 #ifndef NO_GPU
    case DEV_NVIDIA_GPU:
@@ -990,6 +1550,12 @@ int mem_print_stats(int dev_id) //print memory statistics for Device <dev_id>
      printf(" Number of occupied entries      : %d\n",num_args_gpu[i]);
      printf(" Size of occupied entries (bytes): %lu\n",occ_size_gpu[i]);
 //   printf(" Size of all arguments (bytes)   : %lu\n",args_size_gpu[i]);
+     if(mem_get_telemetry(dev_id,&tlm) == 0){
+      printf(" Largest free entry (bytes)      : %lu\n",tlm.largest_free);
+      printf(" Fragmentation ratio             : %f\n",tlm.fragmentation);
+      printf(" Requests (TRY_LATER/DEV_UNABLE) : %lld (%lld/%lld)\n",tlm.num_requests,tlm.num_try_later,tlm.num_device_unable);
+      printf(" Requested/granted size (bytes)  : %lld/%lld\n",tlm.requested_bytes,tlm.granted_bytes);
+     }
     }else{
      printf("\nTAL-SH: GPU #%d is OFF (no memory statistics).\n",i);
     }
@@ -1025,7 +1591,7 @@ int slab_clean(slab_t * slab)
 /** Cleans a statically declared (undefined) slab_t to an empty state.
     Do not call this function on a non-empty slab_t, use slab_destruct() instead! **/
 {
- slab->max_entries=0; slab->entry_size=0; slab->slab_base=NULL; slab->free_entries=NULL;
+ slab->max_entries=0; slab->entry_size=0; slab->slab_base=NULL; slab->free_entries=NULL; slab->mem_external=0;
  return 0;
 }
 
@@ -1042,7 +1608,7 @@ int slab_construct(slab_t * slab, size_t slab_entry_size, size_t slab_max_entrie
 #endif
 
  if(slab == NULL || slab_entry_size == 0 || slab_max_entries == 0) return -1;
- slab->slab_base=NULL; slab->free_entries=NULL; slab->max_entries=0;
+ slab->slab_base=NULL; slab->free_entries=NULL; slab->max_entries=0; slab->mem_external=0;
  if(align == 0){
   slab->entry_size = slab_entry_size;
  }else{
@@ -1079,6 +1645,39 @@ int slab_construct(slab_t * slab, size_t slab_entry_size, size_t slab_max_entrie
  return 0;
 }
 
+int slab_construct_ext(slab_t * slab, size_t slab_entry_size, size_t slab_max_entries, void * slab_mem, size_t align)
+/** Constructs a user-defined slab on an externally provided memory segment of size
+    >= slab_max_entries*entry_size. The memory segment is not owned by the slab. **/
+{
+ size_t j,l;
+
+ if(slab == NULL || slab_entry_size == 0 || slab_max_entries == 0 || slab_mem == NULL) return -1;
+ slab->slab_base=NULL; slab->free_entries=NULL; slab->max_entries=0; slab->mem_external=1;
+#ifndef NO_GPU
+ slab->mem_mapped=0;
+#endif
+ if(align == 0){
+  slab->entry_size = slab_entry_size;
+ }else{
+  if(slab_entry_size%align > 0){
+   slab->entry_size = slab_entry_size - slab_entry_size%align + align;
+  }else{
+   slab->entry_size = slab_entry_size;
+  }
+ }
+ slab->free_entries=(void**)malloc(sizeof(void*)*slab_max_entries);
+ if(slab->free_entries == NULL){slab->entry_size=0; return 1;}
+ slab->slab_base=slab_mem;
+ slab->max_entries=slab_max_entries;
+ slab->alignment=MAX(align,1);
+ slab->first_free=0; j=0;
+ for(l=0;l<slab_max_entries;l++){
+  slab->free_entries[l]=(void*)(&(((char*)(slab->slab_base))[j]));
+  j=j+slab->entry_size;
+ }
+ return 0;
+}
+
 int slab_entry_get(slab_t * slab, void ** slab_entry)
 /** Gets a slab entry. **/
 {
@@ -1171,15 +1770,19 @@ int slab_destruct(slab_t * slab)
  if(slab == NULL) return -1;
  if(slab->slab_base != NULL){
   if(slab->max_entries == 0) errc=NOT_CLEAN;
-#ifndef NO_GPU
-  if(slab->mem_mapped == 0){
-   free(slab->slab_base); slab->slab_base=NULL;
+  if(slab->mem_external != 0){ //memory is not owned by the slab
+   slab->slab_base=NULL;
   }else{
-   err=cudaFreeHost(slab->slab_base); if(err != cudaSuccess) errc=NOT_CLEAN;
-  }
+#ifndef NO_GPU
+   if(slab->mem_mapped == 0){
+    free(slab->slab_base); slab->slab_base=NULL;
+   }else{
+    err=cudaFreeHost(slab->slab_base); if(err != cudaSuccess) errc=NOT_CLEAN;
+   }
 #else
-  free(slab->slab_base); slab->slab_base=NULL;
+   free(slab->slab_base); slab->slab_base=NULL;
 #endif
+  }
  }else{
   if(slab->max_entries > 0){slab->max_entries=0; errc=NOT_CLEAN;}
  }
@@ -1,8 +1,8 @@
 /** ExaTensor::TAL-SH: Memory management API header.
-REVISION: 2019/11/27
+REVISION: 2020/07/14
 
-Copyright (C) 2014-2019 Dmitry I. Lyakh (Liakh)
-Copyright (C) 2014-2019 Oak Ridge National Laboratory (UT-Battelle)
+Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
 
 This file is part of ExaTensor.
 
@@ -24,6 +24,10 @@ along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
 #ifndef MEM_MANAGER_H_
 #define MEM_MANAGER_H_
 
+//Parameters:
+#define MEM_TELEMETRY_MAX_LEVELS 16 //max number of argument buffer levels reported by the telemetry
+#define MEM_TELEMETRY_HIST_BINS 48  //number of size bins in the telemetry histograms (bin k: [2^k..2^(k+1)) bytes)
+
 //Types:
 // Generic slab:
 typedef struct{
@@ -33,11 +37,35 @@ typedef struct{
  size_t first_free;     //first free entry number (stack pointer)
  void * slab_base;      //slab base pointer
  void ** free_entries;  //stack of free entries
+ int mem_external;      //non-zero if the slab memory was provided externally (not owned by the slab)
 #ifndef NO_GPU
  int mem_mapped;        //non-zero if the underlying Host memory was allocated via cudaHostAlloc() as portable mapped
 #endif
 } slab_t;
 
+// Argument buffer telemetry (occupancy state and allocation counters since the last reset):
+typedef struct{
+ size_t buf_size;                                    //total size of the argument buffer in bytes
+ size_t occ_size;                                    //total size of the occupied argument buffer entries in bytes
+ size_t largest_free;                                //size of the largest argument buffer entry which can currently be allocated (bytes)
+ double fragmentation;                               //fragmentation ratio: 1 - largest_free/min(buf_size-occ_size,level_size[0]), 0 if no free space left
+ int num_levels;                                     //number of argument buffer levels
+ size_t level_size[MEM_TELEMETRY_MAX_LEVELS];        //size of the argument buffer entries on each level (bytes)
+ int level_entries[MEM_TELEMETRY_MAX_LEVELS];        //total number of argument buffer entries on each level
+ int level_used[MEM_TELEMETRY_MAX_LEVELS];           //number of argument buffer entries occupied as a whole on each level
+ int level_free[MEM_TELEMETRY_MAX_LEVELS];           //number of maximal free argument buffer entries on each level
+ int num_cached;                                     //number of free lowest-level entries held in the per-thread caches (Host only, counted as occupied)
+ int num_slabs;                                      //number of lowest-level entries carved into sub-entries (Host only)
+ int num_sub_entries;                                //number of sub-entries in use (Host only)
+ long long num_requests;                             //number of allocation requests
+ long long num_try_later;                            //number of allocation requests rejected with TRY_LATER
+ long long num_device_unable;                        //number of allocation requests rejected with DEVICE_UNABLE
+ long long requested_bytes;                          //total size of all satisfied allocation requests (bytes)
+ long long granted_bytes;                            //total size of all granted argument buffer entries (bytes)
+ long long requested_hist[MEM_TELEMETRY_HIST_BINS];  //histogram of requested sizes (all allocation requests)
+ long long granted_hist[MEM_TELEMETRY_HIST_BINS];    //histogram of granted argument buffer entry sizes
+} mem_telemetry_t;
+
 //Exported functions:
 #ifdef __cplusplus
 extern "C"{
@@ -65,6 +93,8 @@ extern "C"{
  void mem_log_finish(); //generic
  int mem_free_left(int dev_id, size_t * free_mem); //generic
  int mem_print_stats(int dev_id); //generic
+ int mem_get_telemetry(int dev_id, mem_telemetry_t * telemetry); //generic
+ int mem_reset_telemetry(int dev_id); //generic
 
  int slab_create(slab_t ** slab);
  int slab_clean(slab_t * slab);
@@ -73,6 +103,7 @@ extern "C"{
 #else
  int slab_construct(slab_t * slab, size_t slab_entry_size, size_t slab_max_entries, size_t align = 0);
 #endif
+ int slab_construct_ext(slab_t * slab, size_t slab_entry_size, size_t slab_max_entries, void * slab_mem, size_t align = 0);
  int slab_entry_get(slab_t * slab, void ** slab_entry);
  int slab_entry_release(slab_t * slab, void * slab_entry);
  int slab_get_base_ptr(slab_t * slab, void ** base_ptr);
@@ -36,6 +36,7 @@ along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
 #define TALSH_CPTAL_MIN_BUF_SIZE 1073741824 //minimun Host argument buffer size that can be used effectively by CP-TAL
 #define TALSH_NO_HOST_BUFFER 16777216 //nominal Host argument buffer size when it is not needed by the application
 #define TALSH_GFLOP_THRESH_GPU 8 //minimal GFlop count to consider executing on a GPU
+#define TALSH_TRANSFER_BANDWIDTH 1e10 //nominal Host-device data transfer bandwidth (bytes/sec) assumed by the performance model
 
 //TAL-SH ERROR CODES (keep consistent with "talshf.F90"):
 #define TALSH_SUCCESS 0
@@ -90,11 +91,13 @@ along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
 #define TALSH_OP_PARTIAL 1
 #define TALSH_OP_DEFINED 2
 #define TALSH_OP_RESOURCED 3
-#define TALSH_OP_LOADED 4
-#define TALSH_OP_SCHEDULED 5
-#define TALSH_OP_COMPLETED 6
-#define TALSH_OP_STORED 7
-#define TALSH_OP_RETIRED 8
+#define TALSH_OP_LOADING 4
+#define TALSH_OP_LOADED 5
+#define TALSH_OP_SCHEDULED 6
+#define TALSH_OP_COMPLETED 7
+#define TALSH_OP_STORING 8
+#define TALSH_OP_STORED 9
+#define TALSH_OP_RETIRED 10
 
 
 //TAL-SH DATA TYPES:
@@ -136,7 +139,7 @@ typedef struct{
 } talsh_task_t;
 
 // Basic tensor operation:
-typedef struct{
+typedef struct talsh_tens_op_s{
  int opkind;                                         //operation kind
  int data_kind;                                      //operational data kind: {R4,R8,C4,C8}
  unsigned int num_args;                              //number of tensor operands: [0..MAX_TENSOR_OPERANDS]
@@ -146,6 +149,9 @@ typedef struct{
  double alpha_imag;                                  //alpha prefactor (scalar factor), imaginary part
  talsh_tens_t tens_arg[MAX_TENSOR_OPERANDS];         //actual tensor operands (actual TAL-SH tensors)
  talsh_task_t task_handle;                           //task handle
+ talsh_task_t slice_handle[MAX_TENSOR_OPERANDS];     //task handles for the asynchronous loading/storing of tensor slices (on Host)
+ struct talsh_tens_op_s * out_prev;                  //previous tensor operation accumulating into the same output slice (or NULL)
+ int out_next;                                       //YEP: output slice is passed on to the next tensor operation instead of being stored
  int exec_dev_id;                                    //execution device id (flat device id)
  int stage;                                          //tensor operation stage
  double time_started;
@@ -187,6 +193,19 @@ extern "C"{
 // Query fast math on a given device:
  int talshQueryFastMath(int dev_kind,
                         int dev_id);
+//  Set the max tensor volume handled by the native C++ CP-TAL on Host (returns the previous value):
+ size_t talshSetHostNativeVolume(size_t max_volume);
+//  Check whether a Host tensor operation on the given tensors would be executed by the native C++ CP-TAL (YEP/NOPE):
+ int talshHostNative(int opkind,
+                     const talsh_tens_t * dtens,
+                     const talsh_tens_t * ltens = NULL,
+                     const talsh_tens_t * rtens = NULL);
+//  Set the number of Host worker threads executing non-blocking Host tasks (returns the previous value):
+ int talshSetHostWorkers(int num_workers);
+//  Save the online performance model (recorded execution times) into a file:
+ int talshPerfModelSave(const char * file_name);
+//  Load the online performance model from a file (merged into the current one):
+ int talshPerfModelLoad(const char * file_name);
 //  Get on-node device count:
  int talshDeviceCount(int dev_kind,
                       int * dev_count);
@@ -360,6 +379,8 @@ extern "C"{
                                           int * num_args);
 //  Get the TAL-SH task status:
  int talshTaskStatus(talsh_task_t * talsh_task);
+//  Get the return code of the tensor operation executed by a finalized TAL-SH task (TRY_LATER/DEVICE_UNABLE: resubmit):
+ int talshTaskOpError(talsh_task_t * talsh_task);
 //  Check whether a TAL-SH task has completed:
  int talshTaskComplete(talsh_task_t * talsh_task,
                        int * stats,
@@ -402,9 +423,12 @@ extern "C"{
  int talshTensorOpSetExecDevice(talsh_tens_op_t * tens_op,
                                 int dev_id,
                                 int dev_kind = DEV_DEFAULT);
+//  Chain tensor operation output with the previous tensor operation (identical output slice):
+ int talshTensorOpChainOutput(talsh_tens_op_t * tens_op,   //inout: tensor operation (defined)
+                              talsh_tens_op_t * prev_op);  //inout: previous tensor operation (defined)
 //  Activate tensor operation for subsequent processing (resources acquired):
  int talshTensorOpActivate(talsh_tens_op_t * tens_op);
-//  Load input (extract input tensor slices):
+//  Load input (schedule extraction of input tensor slices on Host, see talshTensorOpProgress):
  int talshTensorOpLoadInput(talsh_tens_op_t * tens_op);
 //  Schedule tensor operation for execution of a given device:
  int talshTensorOpExecute(talsh_tens_op_t * tens_op,
@@ -414,7 +438,7 @@ extern "C"{
  int talshTensorOpTest(talsh_tens_op_t * tens_op,
                        int * completed,
                        int wait = NOPE);
-//  Store output (insert/accumulate output tensor slice):
+//  Store output (schedule insertion/accumulation of output tensor slice on Host, see talshTensorOpProgress):
  int talshTensorOpStoreOutput(talsh_tens_op_t * tens_op);
 //  Deactivate tensor operation (resources released):
  int talshTensorOpDeactivate(talsh_tens_op_t * tens_op);
@@ -441,6 +465,13 @@ extern "C"{
  int talshTensorOpDecompose2(const talsh_tens_op_t * tens_op, //in: parent tensor operation (defined on entrance)
                              talsh_tens_op_t * child_op1,     //inout: children tensor operation 1 (empty on entrance)
                              talsh_tens_op_t * child_op2);    //inout: children tensor operation 2 (empty on entrance)
+//  Tensor operation decomposition into a k-way tiling of sub-operations fitting the given memory limits:
+ int talshTensorOpDecompose(const talsh_tens_op_t * tens_op,     //in: parent tensor operation (defined on entrance)
+                            size_t arg_max,                      //in: max size of each tensor argument of a sub-operation (bytes)
+                            size_t tot_max,                      //in: max total size of all tensor arguments of a sub-operation (bytes)
+                            int max_ops,                         //in: max number of sub-operations
+                            int * num_ops,                       //out: number of sub-operations
+                            talsh_tens_op_t ** child_ops = NULL); //inout: if not NULL, <num_ops> children tensor operations (empty on entrance)
 //  Print tensor operation:
  void talshTensorOpPrint(const talsh_tens_op_t * tens_op);
 
@@ -542,6 +573,22 @@ extern "C"{
                            int accumulative = YEP);     //in: accumulate in (default) VS overwrite destination tensor: [YEP|NOPE]
  int talshTensorContractXL_(const char * cptrn, talsh_tens_t * dtens, talsh_tens_t * ltens, talsh_tens_t * rtens,
                             double scale_real, double scale_imag, int dev_id, int dev_kind, int accumulative);
+//  Batched tensor addition (blocking, same pattern): dtens[i] += ltens[i] * scale, i=[0..num_ops-1]:
+ int talshTensorAddBatch(const char * cptrn,          //in: C-string: symbolic addition pattern, e.g. "D(a,b,c,d)+=L(c,d,b,a)"
+                         int num_ops,                 //in: number of tensor additions in the batch
+                         talsh_tens_t * dtens[],      //inout: destination tensor blocks
+                         talsh_tens_t * ltens[],      //inout: source tensor blocks
+                         double scale_real = 1.0,     //in: scaling value (real part), defaults to 1
+                         double scale_imag = 0.0);    //in: scaling value (imaginary part), defaults to 0
+//  Batched tensor contraction (blocking, same pattern): dtens[i] += ltens[i] * rtens[i] * scale, i=[0..num_ops-1]:
+ int talshTensorContractBatch(const char * cptrn,      //in: C-string: symbolic contraction pattern, e.g. "D(a,b,c,d)+=L(c,i,j,a)*R(b,j,d,i)"
+                              int num_ops,             //in: number of tensor contractions in the batch
+                              talsh_tens_t * dtens[],  //inout: destination tensor blocks
+                              talsh_tens_t * ltens[],  //inout: left source tensor blocks
+                              talsh_tens_t * rtens[],  //inout: right source tensor blocks
+                              double scale_real = 1.0, //in: scaling value (real part), defaults to 1
+                              double scale_imag = 0.0, //in: scaling value (imaginary part), defaults to 0
+                              int accumulative = YEP); //in: accumulate in (default) VS overwrite destination tensors: [YEP|NOPE]
 //  Tensor decomposition via SVD:
 //   Meaning of parameter <absorb>:
 //    'N': No absorption of stens;
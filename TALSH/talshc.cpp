@@ -23,14 +23,15 @@ along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
 FOR DEVELOPER(s):
  # TAL-SH runtime provides a device-kind unified API for performing basic
    tensor algebra operations on multicore CPU Host, Nvidia GPU, Intel MIC, etc.
-   Tensor algebra tasks scheduled on Host are blocking (the scheduling call
-   returns only after completion of the task). Tensor algebra tasks scheduled
-   on an accelerator are non-blocking/asynchronous. Each TAL-SH tensor may
+   Tensor algebra tasks scheduled on Host with a TAL-SH task handle are
+   executed asynchronously by a pool of Host worker threads, whereas those
+   scheduled without a task handle are blocking (executed by the calling thread).
+   Tensor algebra tasks scheduled on an accelerator are non-blocking/asynchronous. Each TAL-SH tensor may
    be present on multiple devices at a time, where the data transfers and
    data consistency are taken care of by the TAL-SH runtime. Underneath,
    the TAL-SH runtime dispatches tasks to device-kind specific (lower-level)
    runtimes called:
-   CP-TAL(multicore CPU, synchronous),
+   CP-TAL(multicore CPU, synchronous, asynchronous via the Host worker pool),
    NV-TAL (Nvidia GPU, asynchronous),
    XP-TAL (Intel MIC, asynchronous),
    AM-TAL (AMD GPU, asynchronous),
@@ -57,6 +58,14 @@ FOR DEVELOPER(s):
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <math.h>
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <vector>
+#include <algorithm>
 
 #include <omp.h>
 
@@ -65,10 +74,16 @@ FOR DEVELOPER(s):
 #include "mem_manager.h"
 #include "talsh_complex.h"
 #include "talsh.h"
+#include "tensor_algebra_cpu.hpp"
 
 //PARAMETERS:
 static int VERBOSE=1;     //verbosity for errors
 static int LOGGING_OPS=0; //logging basic tensor operations
+static const size_t HOST_NATIVE_VOL=65536; //default max tensor volume (elements) handled by the native C++ CP-TAL
+static const int HOST_WORKERS=2;           //default number of Host worker threads executing non-blocking Host tasks
+static const double PERF_MIN_SAMPLES=2.0;  //min number of recorded executions for a performance model prediction
+static const double PERF_EMA_WEIGHT=0.25;  //weight of a new execution time in the performance model (exponential moving average)
+static const size_t PERF_EXPLORE_RANGE=8;  //CP-TAL implementations are explored within this factor of the native tensor volume threshold
 
 //GLOBALS:
 // General:
@@ -83,17 +98,35 @@ static int talsh_cpu=DEV_OFF;
 static int talsh_gpu[MAX_GPUS_PER_NODE]={DEV_OFF}; //current GPU status: {DEV_OFF,DEV_ON,DEV_ON_BLAS}
 static int talsh_mic[MAX_MICS_PER_NODE]={DEV_OFF}; //current MIC status: {DEV_OFF,DEV_ON,DEV_ON_BLAS}
 static int talsh_amd[MAX_AMDS_PER_NODE]={DEV_OFF}; //current AMD status: {DEV_OFF,DEV_ON,DEV_ON_BLAS}
+// Host backend:
+static size_t talsh_host_native_vol=HOST_NATIVE_VOL; //max tensor volume (elements) handled by the native C++ CP-TAL (0:disabled)
+static int talsh_host_workers=HOST_WORKERS;          //number of Host worker threads (OpenMP threads are split among them)
+static talsh::cpu::TaskPool * talsh_host_pool=NULL;  //Host worker pool (created upon the first non-blocking Host task)
 // Failure statistics:
 static unsigned long long int not_clean_count=0LL; //number of times a NOT_CLEAN status was returned (possible indication of a memory leak)
 
 //INTERNAL TYPES:
 // Host task:
 typedef struct{
- int task_error; //task error code (-1:empty or in progress; 0:success; >0:error code)
+ int task_error; //task error code (-1:empty or in progress; 0:success; >0:error code): Set atomically by Host workers
  int host_id;    //-1:uninitialized (empty task); 0:initialized (non-empty)
  unsigned int coherence; //coherence control value
+ double exec_time;       //execution time (sec) of an asynchronous Host task (-1:not executed)
+ int op_error;           //original return code of the tensor operation of an asynchronous Host task
 } host_task_t;
 
+// Online performance model entry (per operation kind, work size class, execution device, and kernel variant):
+typedef struct{
+ double count;    //number of recorded executions
+ double sec_unit; //execution time per unit of work (sec), exponential moving average
+ double failures; //number of failed executions (a failed kernel variant is not explored any further)
+} perf_entry_t;
+
+//INTERNAL GLOBALS:
+// Online performance model:
+static std::map<unsigned long long int,perf_entry_t> talsh_perf_model; //performance model entries (key: see talsh_perf_key)
+static std::mutex talsh_perf_lock;                                   //guards the performance model (updated by Host workers)
+
 //PROTOTYPES OF IMPORTED FUNCTIONS:
 #ifdef __cplusplus
 extern "C"{
@@ -137,11 +170,27 @@ static int talsh_tensor_image_discard(talsh_tens_t * talsh_tens, int image_id);
 static int talsh_tensor_image_discard_other(talsh_tens_t * talsh_tens, int image_id);
 // Choose an appropriate tensor body image to use in a tensor operation:
 static int talsh_choose_image_for_device(talsh_tens_t * tens, unsigned int coh_ctrl, int * copied, int dvk, int dvn = DEV_NULL);
+// Decide whether the native C++ CP-TAL will process the given Host tensor body images:
+static int talsh_host_native(int opkind, const talsh_tens_t * tens0, int image0, const talsh_tens_t * tens1 = NULL, int image1 = -1,
+                             const talsh_tens_t * tens2 = NULL, int image2 = -1);
+// Online performance model:
+static double talsh_perf_work(const talsh_tens_t * tens0, const talsh_tens_t * tens1 = NULL, const talsh_tens_t * tens2 = NULL);
+static void talsh_perf_record(int opkind, double work, int devid, int variant, double time);
+static void talsh_perf_record_failure(int opkind, double work, int devid, int variant);
+static int talsh_perf_failed(int opkind, double work, int devid, int variant);
+static int talsh_perf_predict(int opkind, double work, int devid, int variant, double * time);
+static std::function<int()> talsh_perf_timed(int opkind, double work, int variant, std::function<int()> host_op);
+static int talsh_perf_choose_device(const talsh_tens_t * tens0, const talsh_tens_t * tens1, const talsh_tens_t * tens2);
+// Batched tensor operations:
+static int talsh_tensor_batch(int opkind, const char * cptrn, int num_ops, talsh_tens_t * dtens[], talsh_tens_t * ltens[],
+                              talsh_tens_t * rtens[], double scale_real, double scale_imag, int accumulative);
 // Host task API:
 static int host_task_create(host_task_t ** host_task);
 static int host_task_clean(host_task_t * host_task);
 static int host_task_is_empty(const host_task_t * host_task);
 static int host_task_record(host_task_t * host_task, unsigned int coh_ctrl, unsigned int error_code);
+static int host_task_submit(host_task_t * host_task, unsigned int coh_ctrl, talsh_tens_t * dtens, std::function<int()> host_op,
+                            std::function<void()> src_restore = nullptr);
 static int host_task_status(host_task_t * host_task);
 static int host_task_error_code(const host_task_t * host_task);
 static int host_task_destroy(host_task_t * host_task);
@@ -155,6 +204,8 @@ static int talshTensorIsHealthy(const talsh_tens_t * talsh_tens);
 static int talshTaskConstruct(talsh_task_t * talsh_task, int dev_kind, int coh_ctrl, int data_kind = NO_TYPE);
 static int talshTaskSetArg(talsh_task_t * talsh_task, talsh_tens_t * talsh_tens_p, int image_id);
 static int talshTaskFinalize(talsh_task_t * talsh_task, int task_status);
+// Additional TAL-SH tensor operation API:
+static int talshTensorOpTestSlices(talsh_tens_op_t * tens_op, int * completed, int wait = NOPE);
 #ifdef __cplusplus
 }
 #endif
@@ -177,6 +228,8 @@ static int host_task_clean(host_task_t * host_task)
  if(host_task == NULL) return TALSH_INVALID_ARGS;
  host_task->task_error=-1;
  host_task->host_id=-1;
+ host_task->exec_time=-1.0;
+ host_task->op_error=TALSH_SUCCESS;
  return TALSH_SUCCESS;
 }
 
@@ -206,16 +259,58 @@ static int host_task_record(host_task_t * host_task, unsigned int coh_ctrl, unsi
  return TALSH_SUCCESS;
 }
 
+static int host_task_submit(host_task_t * host_task, unsigned int coh_ctrl, talsh_tens_t * dtens, std::function<int()> host_op,
+                            std::function<void()> src_restore)
+/** Submits a Host task to the Host worker pool (non-blocking). The tensor operation <host_op>
+    is expected to dissociate its <tensor_block_t> objects itself. Upon its completion, the
+    Host worker makes the destination image available again and records the task status.
+    If the tensor operation returns TRY_LATER or DEVICE_UNABLE, the source images it had marked
+    unavailable are made available again by <src_restore>. The original return code of the
+    tensor operation is kept in the Host task (see talshTaskOpError).
+    TRY_LATER is returned if the Host worker pool cannot be started. **/
+{
+ if(host_task == NULL || dtens == NULL) return TALSH_INVALID_ARGS;
+ if(host_task_is_empty(host_task) != YEP) return TALSH_OBJECT_NOT_EMPTY;
+ omp_set_nest_lock(&talsh_lock);
+ if(talsh_host_pool == NULL){
+  try{
+   talsh_host_pool=new talsh::cpu::TaskPool(talsh_host_workers,omp_get_max_threads());
+  }catch(...){
+   talsh_host_pool=NULL;
+  }
+ }
+ omp_unset_nest_lock(&talsh_lock);
+ if(talsh_host_pool == NULL) return TRY_LATER;
+ host_task->host_id=0; //Host device kind comprises only one device (multicore CPU Host #0)
+ host_task->coherence=coh_ctrl; //task error stays negative until completion (in progress)
+#pragma omp flush
+ talsh_host_pool->submit([host_task,dtens,host_op,src_restore](){
+  double tm=omp_get_wtime();
+  int errc=host_op();
+  if(errc == TALSH_SUCCESS || errc == TRY_LATER || errc == DEVICE_UNABLE) dtens->avail[0] = YEP;
+  if((errc == TRY_LATER || errc == DEVICE_UNABLE) && src_restore) src_restore();
+  host_task->exec_time=omp_get_wtime()-tm;
+  host_task->op_error=errc; //original return code (TRY_LATER/DEVICE_UNABLE: can be resubmitted)
+  if(errc != TALSH_SUCCESS) errc=13;
+#pragma omp flush
+#pragma omp atomic write
+  host_task->task_error=errc; //publish the task completion
+#pragma omp flush
+ });
+ return TALSH_SUCCESS;
+}
+
 static int host_task_status(host_task_t * host_task)
 {
- int errc;
+ int errc,task_error;
 
  if(host_task == NULL) return TALSH_INVALID_ARGS;
  errc=host_task_is_empty(host_task);
  if(errc == NOPE){
-  if(host_task->task_error == 0){
+  task_error=host_task_error_code(host_task);
+  if(task_error == 0){
    return TALSH_TASK_COMPLETED;
-  }else if(host_task->task_error > 0){
+  }else if(task_error > 0){
    return TALSH_TASK_ERROR;
   }
  }else if(errc == YEP){
@@ -227,7 +322,15 @@ static int host_task_status(host_task_t * host_task)
 }
 
 static int host_task_error_code(const host_task_t * host_task)
-{return host_task->task_error;}
+{
+ int task_error;
+
+#pragma omp flush
+#pragma omp atomic read
+ task_error=host_task->task_error;
+#pragma omp flush
+ return task_error;
+}
 
 static int host_task_destroy(host_task_t * host_task)
 {
@@ -245,6 +348,7 @@ static void host_task_print(const host_task_t * host_task)
   printf(" Host task status       : %d\n",host_task->task_error);
   printf(" Host task device id    : %d\n",host_task->host_id);
   printf(" Host task coherence_var: %u\n",host_task->coherence);
+  printf(" Host task exec time    : %f\n",host_task->exec_time);
   printf("#END OF MESSAGE\n");
  }
  return;
@@ -375,6 +479,8 @@ static int talsh_tensor_c_dissoc(tensBlck_t * tensC) //inout: <tensBlck_t> creat
 int talshDetermineOptimalDevice(const talsh_tens_t * tens0, const talsh_tens_t * tens1, const talsh_tens_t * tens2)
 /** Given tensor arguments, returns a flat id of the most appropriate device
     based on the data residence, tensor sizes, and current device occupation.
+    For tensor contractions, the online performance model is used once it has
+    recorded executions on all candidate devices for the given work size class.
     A negative return status indicates an error. **/
 {
  int i,j,devid,al,am,as,good_for_gpu,ov[3][TALSH_MAX_DEV_PRESENT],ovl[3];
@@ -387,6 +493,8 @@ int talshDetermineOptimalDevice(const talsh_tens_t * tens0, const talsh_tens_t *
  s[1]=0; if(tens1 != NULL) s[1]=talshTensorVolume(tens1);
  s[2]=0; if(tens2 != NULL) s[2]=talshTensorVolume(tens2);
  if(s[0] > 0 && s[1] > 0 && s[2] > 0){
+  //Online performance model (once all devices have been modeled):
+  devid=talsh_perf_choose_device(tens0,tens1,tens2); if(devid >= 0) return devid;
   gflops=2.0*sqrt(((double)(s[0]))*((double)(s[1]))*((double)(s[2])))/(1e9);
   if(gflops > (double)(TALSH_GFLOP_THRESH_GPU)) good_for_gpu=1;
  }
@@ -536,6 +644,185 @@ static int talsh_choose_image_for_device(talsh_tens_t * tens, unsigned int coh_c
  return image_id;
 }
 
+static int talsh_host_native(int opkind, const talsh_tens_t * tens0, int image0, const talsh_tens_t * tens1, int image1,
+                             const talsh_tens_t * tens2, int image2)
+/** Returns YEP if a Host tensor operation on the given tensor body images is to be
+    executed by the native C++ CP-TAL (tensor_algebra_cpu.hpp). By default, this is the case
+    when all tensors are small enough for the Fortran <tensor_block_t> aliasing overhead to dominate.
+    Once the online performance model has recorded both CP-TAL implementations for the given
+    operation kind and work size class, the one with the lower predicted execution time is chosen.
+    In the vicinity of the tensor volume threshold, the implementation lacking records is tried,
+    unless it has already failed on this operation kind and work size class. **/
+{
+ const talsh_tens_t * tens[]={tens0,tens1,tens2};
+ const int images[]={image0,image1,image2};
+ int native,pn,pf,devid;
+ size_t vol;
+ double work,tn,tf;
+
+ if(talsh_host_native_vol == 0) return NOPE; //native C++ CP-TAL is disabled
+ native=YEP; vol=0;
+ for(int i=0;i<3;++i){
+  if(tens[i] != NULL){
+   if(!talsh::cpu::valid_data_kind(tens[i]->data_kind[images[i]])) return NOPE;
+   vol=MAX(vol,talshTensorVolume(tens[i]));
+  }
+ }
+ if(vol > talsh_host_native_vol) native=NOPE;
+ work=talsh_perf_work(tens0,tens1,tens2); devid=talshFlatDevId(DEV_HOST,0);
+ pn=talsh_perf_predict(opkind,work,devid,1,&tn);
+ pf=talsh_perf_predict(opkind,work,devid,0,&tf);
+ if(pn == YEP && pf == YEP) return ((tn <= tf) ? YEP : NOPE);
+ if(vol <= talsh_host_native_vol*PERF_EXPLORE_RANGE && vol*PERF_EXPLORE_RANGE >= talsh_host_native_vol){
+  if(native == YEP && pn == YEP && talsh_perf_failed(opkind,work,devid,0) != YEP) return NOPE; //try the Fortran CP-TAL
+  if(native == NOPE && pf == YEP && talsh_perf_failed(opkind,work,devid,1) != YEP) return YEP; //try the native C++ CP-TAL
+ }
+ return native;
+}
+
+static double talsh_perf_work(const talsh_tens_t * tens0, const talsh_tens_t * tens1, const talsh_tens_t * tens2)
+/** Returns the amount of work in a tensor operation, as used by the online performance model:
+    Flop count for tensor contractions, number of accessed tensor elements otherwise. **/
+{
+ double work=0.0;
+ if(tens0 == NULL) return work;
+ double vol0=(double)(talshTensorVolume(tens0));
+ double vol1=0.0; if(tens1 != NULL) vol1=(double)(talshTensorVolume(tens1));
+ if(tens2 != NULL){
+  double vol2=(double)(talshTensorVolume(tens2));
+  work=2.0*sqrt(vol0*vol1*vol2);
+  if(tens0->ndev > 0 && (tens0->data_kind[0] == C4 || tens0->data_kind[0] == C8)) work*=4.0;
+ }else{
+  work=vol0+vol1;
+ }
+ return work;
+}
+
+static unsigned long long int talsh_perf_key(int opkind, double work, int devid, int variant)
+/** Returns the performance model key for a given operation kind, work size class
+    (binary logarithm of the work), flat execution device id, and kernel variant. **/
+{
+ unsigned long long int size_class=0;
+ if(work >= 2.0) size_class=(unsigned long long int)(log2(work));
+ return (((((unsigned long long int)(opkind&0xFFFF))*256ULL + (size_class&0xFFULL))*65536ULL +
+          ((unsigned long long int)(devid&0xFFFF)))*256ULL + ((unsigned long long int)(variant&0xFF)));
+}
+
+static void talsh_perf_record(int opkind, double work, int devid, int variant, double time)
+/** Records the execution time of a tensor operation in the online performance model. **/
+{
+ if(work <= 0.0 || time <= 0.0) return;
+ double sec_unit=time/work;
+ std::lock_guard<std::mutex> lock(talsh_perf_lock);
+ perf_entry_t & entry=talsh_perf_model[talsh_perf_key(opkind,work,devid,variant)];
+ if(entry.count > 0.0){
+  entry.sec_unit+=PERF_EMA_WEIGHT*(sec_unit-entry.sec_unit);
+ }else{
+  entry.sec_unit=sec_unit;
+ }
+ entry.count+=1.0;
+ return;
+}
+
+static void talsh_perf_record_failure(int opkind, double work, int devid, int variant)
+/** Records a failed execution of a tensor operation in the online performance model. **/
+{
+ std::lock_guard<std::mutex> lock(talsh_perf_lock);
+ perf_entry_t & entry=talsh_perf_model[talsh_perf_key(opkind,work,devid,variant)];
+ entry.failures+=1.0;
+ return;
+}
+
+static int talsh_perf_failed(int opkind, double work, int devid, int variant)
+/** Returns YEP if a tensor operation has failed with the given kernel variant
+    without enough successful executions recorded for a prediction, NOPE otherwise. **/
+{
+ std::lock_guard<std::mutex> lock(talsh_perf_lock);
+ auto pos=talsh_perf_model.find(talsh_perf_key(opkind,work,devid,variant));
+ if(pos == talsh_perf_model.end()) return NOPE;
+ if(pos->second.failures > 0.0 && pos->second.count < PERF_MIN_SAMPLES) return YEP;
+ return NOPE;
+}
+
+static int talsh_perf_predict(int opkind, double work, int devid, int variant, double * time)
+/** Predicts the execution time of a tensor operation from the online performance model.
+    Returns YEP if the prediction is available (enough recorded executions), NOPE otherwise. **/
+{
+ std::lock_guard<std::mutex> lock(talsh_perf_lock);
+ auto pos=talsh_perf_model.find(talsh_perf_key(opkind,work,devid,variant));
+ if(pos == talsh_perf_model.end()) return NOPE;
+ if(pos->second.count < PERF_MIN_SAMPLES) return NOPE;
+ *time=work*(pos->second.sec_unit);
+ return YEP;
+}
+
+static std::function<int()> talsh_perf_timed(int opkind, double work, int variant, std::function<int()> host_op)
+/** Returns the Host tensor operation <host_op> augmented with recording of its
+    execution time (if successful) or its failure in the online performance model.
+    A lack of resources (TRY_LATER) is not a failure of the kernel variant. **/
+{
+ return [=]()->int{
+  double tm=omp_get_wtime();
+  int errc=host_op();
+  if(errc == TALSH_SUCCESS){
+   talsh_perf_record(opkind,work,talshFlatDevId(DEV_HOST,0),variant,omp_get_wtime()-tm);
+  }else if(errc != TRY_LATER){
+   talsh_perf_record_failure(opkind,work,talshFlatDevId(DEV_HOST,0),variant);
+  }
+  return errc;
+ };
+}
+
+static int talsh_perf_choose_device(const talsh_tens_t * tens0, const talsh_tens_t * tens1, const talsh_tens_t * tens2)
+/** Returns the flat id of the device with the lowest predicted completion time of a tensor
+    contraction (queue wait, data movement, execution), or DEV_NULL if there is no choice or
+    some device has not been modeled yet (then the static heuristics will explore it). **/
+{
+ const talsh_tens_t * tens[]={tens0,tens1,tens2};
+ int devs[1+MAX_GPUS_PER_NODE],ndevs,devid,dks,queue;
+ double work,texe,tmov,tcomp,tbest,tx;
+
+ ndevs=0; devs[ndevs++]=talshFlatDevId(DEV_HOST,0);
+#ifndef NO_GPU
+ for(int i=talsh_gpu_beg;i<=talsh_gpu_end;++i){if(talsh_gpu[i] != DEV_OFF) devs[ndevs++]=talshFlatDevId(DEV_NVIDIA_GPU,i);}
+#endif
+ if(ndevs < 2) return DEV_NULL;
+ work=talsh_perf_work(tens0,tens1,tens2);
+ devid=DEV_NULL; tbest=0.0;
+ for(int n=0;n<ndevs;++n){
+  //Execution time and queue depth:
+  if(n == 0){ //Host (best CP-TAL implementation)
+   int pf=talsh_perf_predict(TALSH_TENSOR_CONTRACT,work,devs[n],0,&texe);
+   int pn=talsh_perf_predict(TALSH_TENSOR_CONTRACT,work,devs[n],1,&tx);
+   if(pf != YEP && pn != YEP) return DEV_NULL;
+   if(pn == YEP && (pf != YEP || tx < texe)) texe=tx;
+   queue=0;
+   omp_set_nest_lock(&talsh_lock);
+   if(talsh_host_pool != NULL) queue=talsh_host_pool->getNumPending()/talsh_host_pool->getNumWorkers();
+   omp_unset_nest_lock(&talsh_lock);
+  }else{ //accelerator
+   if(talsh_perf_predict(TALSH_TENSOR_CONTRACT,work,devs[n],0,&texe) != YEP) return DEV_NULL;
+   queue=0;
+#ifndef NO_GPU
+   queue=gpu_queue_depth(talshKindDevId(devs[n],&dks));
+#endif
+  }
+  //Data movement (tensors without an available image on the device):
+  tmov=0.0;
+  for(int i=0;i<3;++i){
+   int present=NOPE;
+   for(int j=0;j<tens[i]->ndev;++j){
+    if(tens[i]->avail[j] == YEP && tens[i]->dev_rsc[j].dev_id == devs[n]){present=YEP; break;}
+   }
+   if(present != YEP && talshValidDataKind(tens[i]->data_kind[0],&dks) == YEP)
+    tmov+=((double)(talshTensorVolume(tens[i])))*((double)dks)/TALSH_TRANSFER_BANDWIDTH;
+  }
+  tcomp=texe*((double)(1+queue))+tmov;
+  if(devid == DEV_NULL || tcomp < tbest){devid=devs[n]; tbest=tcomp;}
+ }
+ return devid;
+}
+
 //EXPORTED FUNCTIONS:
 // TAL-SH helper functions:
 int talsh_tens_no_init(const talsh_tens_data_t * tens_data,
@@ -623,6 +910,8 @@ int talshInit(size_t * host_buf_size,    //inout: Host Argument Buffer size in b
  talsh_gpu_beg=gpu_beg; talsh_gpu_end=gpu_end;
  omp_init_nest_lock(&talsh_lock);
  talsh_on=1; talsh_begin_time=clock();
+ const char * perf_model_file=getenv("TALSH_PERF_MODEL"); //persistent online performance model (optional)
+ if(perf_model_file != NULL) errc=talshPerfModelLoad(perf_model_file);
 #pragma omp flush
  return TALSH_SUCCESS;
 }
@@ -634,6 +923,12 @@ int talshShutdown()
 
 #pragma omp flush
  if(talsh_on == 0) return TALSH_NOT_INITIALIZED;
+ if(talsh_host_pool != NULL){delete talsh_host_pool; talsh_host_pool=NULL;} //completes all pending Host tasks
+ const char * perf_model_file=getenv("TALSH_PERF_MODEL"); //persistent online performance model (optional)
+ if(perf_model_file != NULL){
+  errc=talshPerfModelSave(perf_model_file);
+  if(errc != TALSH_SUCCESS && VERBOSE) printf("#WARNING(talshShutdown): Unable to save the performance model into %s\n",perf_model_file);
+ }
  talshSetMemAllocPolicyHost(TALSH_MEM_ALLOC_POLICY_HOST,TALSH_MEM_ALLOC_FALLBACK_HOST,&i);
  errc=arg_buf_deallocate(talsh_gpu_beg,talsh_gpu_end);
  talsh_gpu_beg=0; talsh_gpu_end=-1; talsh_on=0;
@@ -712,6 +1007,106 @@ int talshQueryFastMath(int dev_kind, int dev_id)
  return ans;
 }
 
+size_t talshSetHostNativeVolume(size_t max_volume)
+/** Sets the max tensor volume (number of elements) handled by the native C++ CP-TAL
+    on Host, returning the previous value. Zero routes all Host tensor operations
+    to the Fortran CP-TAL, except the ones it does not implement. **/
+{
+ size_t old_volume;
+
+#pragma omp flush
+ old_volume=talsh_host_native_vol;
+ talsh_host_native_vol=max_volume;
+#pragma omp flush
+ return old_volume;
+}
+
+int talshHostNative(int opkind, const talsh_tens_t * dtens, const talsh_tens_t * ltens, const talsh_tens_t * rtens)
+/** Returns YEP if a Host tensor operation of kind <opkind> on the given tensors (their first body images)
+    would currently be executed by the native C++ CP-TAL, NOPE if by the Fortran CP-TAL, or an error code. **/
+{
+ const talsh_tens_t * tens[]={dtens,ltens,rtens};
+
+ if(talsh_on == 0) return TALSH_NOT_INITIALIZED;
+ if(dtens == NULL) return TALSH_INVALID_ARGS;
+ for(int i=0;i<3;++i){
+  if(tens[i] != NULL){
+   if(talshTensorIsEmpty(tens[i]) != NOPE || tens[i]->ndev <= 0) return TALSH_INVALID_ARGS;
+  }
+ }
+ return talsh_host_native(opkind,dtens,0,ltens,((ltens != NULL) ? 0 : -1),rtens,((rtens != NULL) ? 0 : -1));
+}
+
+int talshSetHostWorkers(int num_workers)
+/** Sets the number of Host worker threads executing non-blocking Host tasks
+    (the OpenMP threads of the Host are evenly split among them), returning
+    the previous value. The current Host worker pool, if any, is drained and
+    shut down, a new one will be started upon the next non-blocking Host task. **/
+{
+ int old_workers;
+
+#pragma omp flush
+ if(num_workers <= 0) return TALSH_INVALID_ARGS;
+ if(talsh_on == 0){ //no Host worker pool exists before TAL-SH initialization
+  old_workers=talsh_host_workers; talsh_host_workers=num_workers;
+  return old_workers;
+ }
+ omp_set_nest_lock(&talsh_lock);
+ old_workers=talsh_host_workers;
+ talsh_host_workers=num_workers;
+ if(talsh_host_pool != NULL){delete talsh_host_pool; talsh_host_pool=NULL;} //completes all pending Host tasks
+ omp_unset_nest_lock(&talsh_lock);
+#pragma omp flush
+ return old_workers;
+}
+
+int talshPerfModelSave(const char * file_name)
+/** Saves the online performance model (recorded execution times and failures of tensor operations
+    per operation kind, work size class, execution device, and kernel variant) into a text file:
+    One line per entry: <key> <number of executions> <time per unit of work> <number of failures>. **/
+{
+ FILE * model_file;
+
+ if(file_name == NULL) return TALSH_INVALID_ARGS;
+ model_file=fopen(file_name,"w"); if(model_file == NULL) return TALSH_FAILURE;
+ int errc=TALSH_SUCCESS;
+ {
+  std::lock_guard<std::mutex> lock(talsh_perf_lock);
+  for(const auto & entry: talsh_perf_model){
+   if(fprintf(model_file,"%llu %.1f %.17e %.1f\n",entry.first,entry.second.count,entry.second.sec_unit,
+              entry.second.failures) < 0){errc=TALSH_FAILURE; break;}
+  }
+ }
+ if(fclose(model_file) != 0) errc=TALSH_FAILURE;
+ return errc;
+}
+
+int talshPerfModelLoad(const char * file_name)
+/** Loads the online performance model from a text file written by talshPerfModelSave().
+    The loaded entries replace the corresponding entries of the current performance model.
+    Files without the number of failures (older format) are accepted as well. **/
+{
+ FILE * model_file;
+ unsigned long long int key;
+ perf_entry_t entry;
+ char line[256];
+
+ if(file_name == NULL) return TALSH_INVALID_ARGS;
+ model_file=fopen(file_name,"r"); if(model_file == NULL) return TALSH_NOT_FOUND;
+ int errc=TALSH_SUCCESS;
+ {
+  std::lock_guard<std::mutex> lock(talsh_perf_lock);
+  while(fgets(line,sizeof(line),model_file) != NULL){
+   entry.failures=0.0;
+   int n=sscanf(line,"%llu %lf %lf %lf",&key,&(entry.count),&(entry.sec_unit),&(entry.failures));
+   if(n < 3){errc=TALSH_FAILURE; break;} //malformed file
+   if((entry.count > 0.0 && entry.sec_unit > 0.0) || entry.failures > 0.0) talsh_perf_model[key]=entry;
+  }
+ }
+ fclose(model_file);
+ return errc;
+}
+
 int talshDeviceCount(int dev_kind, int * dev_count)
 /** Returns the total number of devices of specific kind found on node. **/
 {
@@ -1067,7 +1462,8 @@ int talshStats(int dev_id,   //in: device id (either flat or kind specific devic
    }
    break;
   case DEV_HOST:
-   rc=TALSH_NOT_IMPLEMENTED; //`Implement
+   rc=mem_print_stats(talshFlatDevId(DEV_HOST,0)); //Host argument buffer state and telemetry
+   if(rc != 0) rc=TALSH_FAILURE;
    break;
   case DEV_NVIDIA_GPU:
 #ifndef NO_GPU
@@ -2078,6 +2474,7 @@ static int talshTaskFinalize(talsh_task_t * talsh_task, int task_status)
        case DEV_HOST: //Host: Destination images are created explicitly in the TAL-SH operation and tensor aliases are destroyed there as well
         host_task=(host_task_t*)(talsh_task->task_p);
         talsh_task->task_error=host_task_error_code(host_task);
+        if(host_task->exec_time >= 0.0) talsh_task->exec_time=host_task->exec_time; //asynchronous Host task
         break;
        case DEV_NVIDIA_GPU:
 #ifndef NO_GPU
@@ -2162,6 +2559,15 @@ static int talshTaskFinalize(talsh_task_t * talsh_task, int task_status)
    talsh_task->task_error=13; //task error
   }
  }
+#ifndef NO_GPU
+ //Record the execution time of a successful GPU tensor contraction in the online performance model:
+ if(talsh_task->dev_kind == DEV_NVIDIA_GPU && talsh_task->task_error == 0 && talsh_task->flops > 0.0 && talsh_task->task_p != NULL){
+  cuda_task=(cudaTask_t*)(talsh_task->task_p);
+  double tm=(double)(cuda_task_time(cuda_task));
+  if(tm > 0.0) talsh_perf_record(TALSH_TENSOR_CONTRACT,talsh_task->flops,
+                                 talshFlatDevId(DEV_NVIDIA_GPU,cuda_task_gpu_id(cuda_task)),0,tm);
+ }
+#endif
 #pragma omp flush
  return errc;
 }
@@ -2369,6 +2775,27 @@ int talshTaskStatus(talsh_task_t * talsh_task)
  return errc;
 }
 
+int talshTaskOpError(talsh_task_t * talsh_task)
+/** Returns the return code of the tensor operation executed by a finalized TAL-SH task:
+    TALSH_SUCCESS on success, TRY_LATER or DEVICE_UNABLE if an asynchronous Host tensor operation
+    could not be executed at that time (the task can be resubmitted), some other error code otherwise.
+    TALSH_IN_PROGRESS is returned if the TAL-SH task has not been finalized yet. **/
+{
+ host_task_t *host_task_p;
+
+#pragma omp flush
+ if(talsh_on == 0) return TALSH_NOT_INITIALIZED;
+ if(talsh_task == NULL) return TALSH_INVALID_ARGS;
+ if(talsh_task->dev_kind == DEV_NULL) return TALSH_TASK_EMPTY;
+ if(talsh_task->task_error < 0) return TALSH_IN_PROGRESS;
+ if(talsh_task->task_error == 0) return TALSH_SUCCESS;
+ if(talsh_task->dev_kind == DEV_HOST && talsh_task->task_p != NULL){
+  host_task_p=((host_task_t*)(talsh_task->task_p));
+  if(host_task_p->op_error != TALSH_SUCCESS) return host_task_p->op_error;
+ }
+ return TALSH_FAILURE;
+}
+
 int talshTaskComplete(talsh_task_t * talsh_task, int * stats, int * ierr)
 /** Returns YEP if the TAL-SH has completed, NOPE otherwise.
     The TAL-SH task status will be returned in <stats>. **/
@@ -2448,7 +2875,10 @@ int talshTaskWait(talsh_task_t * talsh_task, int * stats)
  if(talsh_on == 0) return TALSH_NOT_INITIALIZED;
  if(talsh_task == NULL || stats == NULL) return TALSH_INVALID_ARGS;
  errc=TALSH_SUCCESS;
- while(talshTaskComplete(talsh_task,stats,&errc) == NOPE){if(errc != TALSH_SUCCESS) break;};
+ while(talshTaskComplete(talsh_task,stats,&errc) == NOPE){
+  if(errc != TALSH_SUCCESS) break;
+  if(talsh_task->dev_kind == DEV_HOST) std::this_thread::yield(); //leave the cores to the Host workers
+ };
  return errc;
 }
 
@@ -2470,6 +2900,7 @@ int talshTasksWait(int ntasks, talsh_task_t talsh_tasks[], int stats[])
     if(errc != TALSH_SUCCESS) return TALSH_FAILURE;
    }
   }
+  if(tc > 0) std::this_thread::yield(); //leave the cores to the Host workers
  }
  return TALSH_SUCCESS;
 }
@@ -2592,7 +3023,13 @@ int talshTensorOpClean(talsh_tens_op_t * tens_op)
   tens_op->alpha_real = 0.0;
   tens_op->alpha_imag = 0.0;
   tens_op->exec_dev_id = DEV_NULL;
+  tens_op->out_prev = NULL;
+  tens_op->out_next = NOPE;
   errc = talshTaskClean(&(tens_op->task_handle));
+  for(int i = 0; i < MAX_TENSOR_OPERANDS; ++i){
+   if(errc != TALSH_SUCCESS) break;
+   errc = talshTaskClean(&(tens_op->slice_handle[i]));
+  }
   if(errc == TALSH_SUCCESS){
    for(int i = 0; i < MAX_TENSOR_OPERANDS; ++i){
     errc = talshTensorSliceClean(&(tens_op->tens_slice[i])); if(errc != TALSH_SUCCESS) break;
@@ -2675,6 +3112,41 @@ int talshTensorOpSetExecDevice(talsh_tens_op_t * tens_op, int dev_id, int dev_ki
  return errc;
 }
 
+int talshTensorOpChainOutput(talsh_tens_op_t * tens_op, talsh_tens_op_t * prev_op)
+/** Makes the tensor operation accumulate into the output tensor slice of the previous tensor operation
+    which must have an identical output slice (output-stationary accumulation). Instead of being stored,
+    the output slice is passed on along the chain of tensor operations and is stored only once, by the
+    last tensor operation of the chain. Chained tensor operations are executed one after another. **/
+{
+ if(tens_op == NULL || prev_op == NULL || tens_op == prev_op) return TALSH_INVALID_ARGS;
+ int errc = TALSH_SUCCESS;
+ if(tens_op->stage == TALSH_OP_DEFINED && prev_op->stage == TALSH_OP_DEFINED){
+  if(tens_op->out_prev == NULL && prev_op->out_next == NOPE && tens_op->num_args > 0 && prev_op->num_args > 0){
+   const talsh_tens_slice_t * slice = &(tens_op->tens_slice[0]);
+   const talsh_tens_slice_t * prev_slice = &(prev_op->tens_slice[0]);
+   if(slice->tensor == prev_slice->tensor && tens_op->data_kind == prev_op->data_kind){
+    int n = talshTensorRank(slice->tensor);
+    for(int i = 0; i < n; ++i){
+     if(slice->bases.offsets[i] != prev_slice->bases.offsets[i] || slice->shape.dims[i] != prev_slice->shape.dims[i]){
+      errc = TALSH_INVALID_ARGS; break;
+     }
+    }
+   }else{
+    errc = TALSH_INVALID_ARGS;
+   }
+   if(errc == TALSH_SUCCESS){
+    tens_op->out_prev = prev_op;
+    prev_op->out_next = YEP;
+   }
+  }else{
+   errc = TALSH_NOT_ALLOWED;
+  }
+ }else{
+  errc = TALSH_NOT_ALLOWED;
+ }
+ return errc;
+}
+
 int talshTensorOpActivate(talsh_tens_op_t * tens_op)
 /** Activates the tensor operation for a subsequent execution with the previously
     specified data kind for all tensors (acquires execution resources). **/
@@ -2690,6 +3162,7 @@ int talshTensorOpActivate(talsh_tens_op_t * tens_op)
    const talsh_tens_t * host_tensor = slice->tensor;
    talsh_tens_t * tensor = &(tens_op->tens_arg[i]);
    errc = talshTensorClean(tensor); if(errc != TALSH_SUCCESS) break;
+   if(i == 0 && tens_op->out_prev != NULL) continue; //output tensor will be passed on from the previous tensor operation
    errc = talshTensorConstruct(tensor,tens_op->data_kind,talshTensorRank(host_tensor),slice->shape.dims,
                                talshFlatDevId(DEV_HOST,0),NULL,YEP,talsh_tens_no_init);
    if(errc != TALSH_SUCCESS) break;
@@ -2701,8 +3174,37 @@ int talshTensorOpActivate(talsh_tens_op_t * tens_op)
  return errc;
 }
 
+static int talshTensorOpTestSlices(talsh_tens_op_t * tens_op, int * completed, int wait)
+/** Tests for completion of the loading/storing of tensor slices (completed slice tasks are destructed). **/
+{
+ int sts,ier;
+
+ if(tens_op == NULL || completed == NULL) return TALSH_INVALID_ARGS;
+ *completed = YEP;
+ int errc = TALSH_SUCCESS;
+ for(int i = 0; i < tens_op->num_args; ++i){
+  talsh_task_t * task = &(tens_op->slice_handle[i]);
+  if(talshTaskIsEmpty(task) == YEP) continue;
+  if(wait == YEP){
+   errc = talshTaskWait(task,&sts);
+  }else{
+   if(talshTaskComplete(task,&sts,&errc) != YEP){
+    if(errc == TALSH_SUCCESS){*completed = NOPE; continue;}
+   }
+  }
+  if(errc != TALSH_SUCCESS) break;
+  ier = talshTaskDestruct(task);
+  if(sts != TALSH_TASK_COMPLETED){errc = TALSH_TASK_ERROR; break;}
+  if(ier != TALSH_SUCCESS){errc = ier; break;}
+ }
+ if(errc != TALSH_SUCCESS) *completed = NOPE;
+ return errc;
+}
+
 int talshTensorOpLoadInput(talsh_tens_op_t * tens_op)
-/** Loads input tensor slices. **/
+/** Schedules loading of input tensor slices (non-blocking slice extractions on Host).
+    Upon success, the tensor operation is LOADING until the slices are loaded.
+    On TRY_LATER, the already scheduled slice extractions are kept. **/
 {
  int offs[MAX_TENSOR_RANK];
 
@@ -2710,14 +3212,16 @@ int talshTensorOpLoadInput(talsh_tens_op_t * tens_op)
  int errc = TALSH_SUCCESS;
  if(tens_op->stage == TALSH_OP_RESOURCED){
   for(int i = 1; i < tens_op->num_args; ++i){ //input slices only
+   if(talshTaskIsEmpty(&(tens_op->slice_handle[i])) != YEP) continue; //already scheduled
    talsh_tens_t * dtens = &(tens_op->tens_arg[i]);
    talsh_tens_t * ltens = tens_op->tens_slice[i].tensor;
    int nd = talshTensorRank(ltens);
    if(nd != talshTensorRank(dtens)){errc = TALSH_OBJECT_BROKEN; break;}
    for(int j = 0; j < nd; ++j) offs[j] = (int)(tens_op->tens_slice[i].bases.offsets[j]); //`integer overflow
-   errc = talshTensorSlice(dtens,ltens,offs,0,DEV_HOST,COPY_MT); if(errc != TALSH_SUCCESS) break;
+   errc = talshTensorSlice(dtens,ltens,offs,0,DEV_HOST,COPY_MT,NOPE,&(tens_op->slice_handle[i]));
+   if(errc != TALSH_SUCCESS){talshTaskDestruct(&(tens_op->slice_handle[i])); break;} //task has not been scheduled
   }
-  if(errc == TALSH_SUCCESS) tens_op->stage = TALSH_OP_LOADED;
+  if(errc == TALSH_SUCCESS) tens_op->stage = TALSH_OP_LOADING;
  }else{
   errc = TALSH_NOT_ALLOWED;
  }
@@ -2725,11 +3229,23 @@ int talshTensorOpLoadInput(talsh_tens_op_t * tens_op)
 }
 
 int talshTensorOpExecute(talsh_tens_op_t * tens_op, int dev_id, int dev_kind)
-/** Schedules execution of the tensor operation on a given device. **/
+/** Schedules execution of the tensor operation on a given device. A chained tensor
+    operation returns TRY_LATER until the previous tensor operation has completed
+    and passed on its output tensor slice, into which it then accumulates. **/
 {
  if(tens_op == NULL) return TALSH_INVALID_ARGS;
  int errc = TALSH_SUCCESS;
  if(tens_op->stage == TALSH_OP_LOADED){
+  if(tens_op->out_prev != NULL && tens_op->num_args > 0){ //take over the output tensor slice of the previous tensor operation
+   if(talshTensorIsEmpty(&(tens_op->tens_arg[0])) == YEP){
+    talsh_tens_op_t * prev_op = tens_op->out_prev;
+    if(prev_op->stage != TALSH_OP_COMPLETED || talshTensorIsEmpty(&(prev_op->tens_arg[0])) != NOPE) return TRY_LATER;
+    tens_op->tens_arg[0] = prev_op->tens_arg[0]; //move
+    errc = talshTensorClean(&(prev_op->tens_arg[0]));
+#pragma omp flush
+    if(errc != TALSH_SUCCESS) return errc;
+   }
+  }
   if(tens_op->exec_dev_id != DEV_NULL){ //execution device is already preset in the tensor operation
    if(dev_id == DEV_DEFAULT && dev_kind == DEV_DEFAULT){
     dev_id = talshKindDevId(tens_op->exec_dev_id,&dev_kind);
@@ -2755,7 +3271,7 @@ int talshTensorOpExecute(talsh_tens_op_t * tens_op, int dev_id, int dev_kind)
     errc = talshTensorContract(tens_op->symb_pattern,
                                &(tens_op->tens_arg[0]),&(tens_op->tens_arg[1]),&(tens_op->tens_arg[2]),
                                tens_op->alpha_real,tens_op->alpha_imag,
-                               dev_id,dev_kind,COPY_TTT,NOPE,&(tens_op->task_handle));
+                               dev_id,dev_kind,COPY_TTT,((tens_op->out_prev != NULL) ? YEP : NOPE),&(tens_op->task_handle));
     if(errc != TALSH_SUCCESS && errc != TRY_LATER && errc != DEVICE_UNABLE){
      if(VERBOSE) printf("#ERROR(talshTensorOpExecute): talshTensorContract error %d\n",errc);
     }
@@ -2798,25 +3314,32 @@ int talshTensorOpTest(talsh_tens_op_t * tens_op, int * completed, int wait)
 }
 
 int talshTensorOpStoreOutput(talsh_tens_op_t * tens_op)
-/** Stores/accumulates output tensor slice. **/
+/** Schedules storing of the output tensor slice (non-blocking accumulative insertion on Host).
+    Upon success, the tensor operation is STORING until the slice is stored. Output slices
+    of different tensor operations may overlap, thus their storing must not be concurrent.
+    A tensor operation chained with the next one does not store its output slice but returns
+    TRY_LATER until the next tensor operation has taken it over. **/
 {
  int offs[MAX_TENSOR_RANK];
 
  if(tens_op == NULL) return TALSH_INVALID_ARGS;
  int errc = TALSH_SUCCESS;
  if(tens_op->stage == TALSH_OP_COMPLETED){
-  if(tens_op->num_args > 0){
+  if(tens_op->out_next == YEP){ //output slice is passed on to the next tensor operation
+   if(tens_op->num_args > 0 && talshTensorIsEmpty(&(tens_op->tens_arg[0])) != YEP) return TRY_LATER;
+  }else if(tens_op->num_args > 0){
    talsh_tens_t * ltens = &(tens_op->tens_arg[0]);
    talsh_tens_t * dtens = tens_op->tens_slice[0].tensor;
    int nd = talshTensorRank(dtens);
    if(nd == talshTensorRank(ltens)){
     for(int j = 0; j < nd; ++j) offs[j] = (int)(tens_op->tens_slice[0].bases.offsets[j]); //`integer overflow
-    errc = talshTensorInsert(dtens,ltens,offs,0,DEV_HOST,COPY_MT,YEP); //accumulative insert
+    errc = talshTensorInsert(dtens,ltens,offs,0,DEV_HOST,COPY_MT,YEP,&(tens_op->slice_handle[0])); //accumulative insert
+    if(errc != TALSH_SUCCESS) talshTaskDestruct(&(tens_op->slice_handle[0])); //task has not been scheduled
    }else{
     errc = TALSH_OBJECT_BROKEN;
    }
   }
-  if(errc == TALSH_SUCCESS) tens_op->stage = TALSH_OP_STORED;
+  if(errc == TALSH_SUCCESS) tens_op->stage = TALSH_OP_STORING;
  }else{
   errc = TALSH_NOT_ALLOWED;
  }
@@ -2855,8 +3378,17 @@ int talshTensorOpDestruct(talsh_tens_op_t * tens_op)
 {
  if(tens_op == NULL) return TALSH_INVALID_ARGS;
  int errc = TALSH_SUCCESS;
+ for(int i = 0; i < tens_op->num_args; ++i){ //slice loading/storing tasks
+  int stat = talshTaskStatus(&(tens_op->slice_handle[i]));
+  if(stat == TALSH_TASK_COMPLETED || stat == TALSH_TASK_ERROR){
+   errc = talshTaskDestruct(&(tens_op->slice_handle[i])); if(errc != TALSH_SUCCESS) break;
+  }else if(stat != TALSH_TASK_EMPTY){
+   if(VERBOSE) printf("#ERROR(talshTensorOpDestruct): Attempt to destruct a tensor operation with active slice tasks\n");
+   return TALSH_IN_PROGRESS;
+  }
+ }
  int stat = talshTaskStatus(&(tens_op->task_handle));
- if(stat == TALSH_TASK_COMPLETED || stat == TALSH_TASK_ERROR){
+ if(errc == TALSH_SUCCESS && (stat == TALSH_TASK_COMPLETED || stat == TALSH_TASK_ERROR)){
   errc = talshTaskDestruct(&(tens_op->task_handle));
   stat = talshTaskStatus(&(tens_op->task_handle));
  }
@@ -2901,7 +3433,8 @@ int talshTensorOpProgress(talsh_tens_op_t * tens_op, int * done)
     operation is fully completed, returns YEP in <done>.
     Rules for progressing:
     (a) A synchronous operation is progressed until its completion;
-    (b) An asynchronous operation is scheduled only, followed by Yield
+    (b) An asynchronous operation (input slice loading, execution,
+        output slice storing) is scheduled only, followed by Yield
         to the next operation;
     (c) A test for asynchronous operation completion is considered
         an asynchronous operation if FALSE, otherwise it is considered
@@ -2910,7 +3443,7 @@ int talshTensorOpProgress(talsh_tens_op_t * tens_op, int * done)
  const bool SHOW_PROGRESS = false;
  const bool CHECK_NORMS = false;
  int completed;
- double tm;
+ double tm,tnorm1,snorm1;
 
  *done = NOPE;
  if(tens_op == NULL) return TALSH_INVALID_ARGS;
@@ -2935,11 +3468,23 @@ int talshTensorOpProgress(talsh_tens_op_t * tens_op, int * done)
   tm = time_sys_sec() - tm;
   if(errc == TALSH_SUCCESS){
    if(SHOW_PROGRESS)
-   printf("#DEBUG(talshTensorOpProgress): Loaded tensor operation %p in %.4f sec\n",tens_op,tm); //debug
+   printf("#DEBUG(talshTensorOpProgress): Started loading tensor operation %p in %.4f sec\n",tens_op,tm); //debug
    errc = talshTensorOpProgress(tens_op,done);
   }else{
    if(errc != TRY_LATER && VERBOSE)
-   printf("#ERROR(talshTensorOpProgress): RESOURCED->LOADED error for tensor operation %p\n",errc,tens_op);
+   printf("#ERROR(talshTensorOpProgress): RESOURCED->LOADING error %d for tensor operation %p\n",errc,tens_op);
+  }
+  break;
+ case TALSH_OP_LOADING:
+  errc = talshTensorOpTestSlices(tens_op,&completed,NOPE);
+  if(errc == TALSH_SUCCESS && completed == YEP){
+   tens_op->stage = TALSH_OP_LOADED;
+   if(SHOW_PROGRESS)
+   printf("#DEBUG(talshTensorOpProgress): Loaded tensor operation %p\n",tens_op); //debug
+   errc = talshTensorOpProgress(tens_op,done);
+  }else{
+   if(errc != TALSH_SUCCESS && errc != TRY_LATER && VERBOSE)
+   printf("#ERROR(talshTensorOpProgress): LOADING->LOADED error %d for tensor operation %p\n",errc,tens_op);
   }
   break;
  case TALSH_OP_LOADED:
@@ -2964,27 +3509,38 @@ int talshTensorOpProgress(talsh_tens_op_t * tens_op, int * done)
   }
   break;
  case TALSH_OP_COMPLETED:
-  double tnorm1,snorm1;
   if(CHECK_NORMS){
    talshTensorOpPrint(tens_op);
    tnorm1 = talshTensorImageNorm1_cpu(tens_op->tens_slice[0].tensor);
    snorm1 = talshTensorImageNorm1_cpu(&(tens_op->tens_arg[0]));
-   printf("#DEBUG(talshTensorOpProgress): Tensor operation %p slice 1-norm = %e\n",tens_op,snorm1);
+   printf("#DEBUG(talshTensorOpProgress): Tensor operation %p slice 1-norm = %e (destination %e)\n",tens_op,snorm1,tnorm1);
   }
   tm = time_sys_sec();
   errc = talshTensorOpStoreOutput(tens_op);
   tm = time_sys_sec() - tm;
   if(errc == TALSH_SUCCESS){
    if(SHOW_PROGRESS)
-   printf("#DEBUG(talshTensorOpProgress): Stored tensor operation %p in %.4f sec\n",tens_op,tm); //debug
+   printf("#DEBUG(talshTensorOpProgress): Started storing tensor operation %p in %.4f sec\n",tens_op,tm); //debug
+   errc = talshTensorOpProgress(tens_op,done);
+  }else{
+   if(errc != TRY_LATER && VERBOSE)
+   printf("#ERROR(talshTensorOpProgress): COMPLETED->STORING error %d for tensor operation %p\n",errc,tens_op);
+  }
+  break;
+ case TALSH_OP_STORING:
+  errc = talshTensorOpTestSlices(tens_op,&completed,NOPE);
+  if(errc == TALSH_SUCCESS && completed == YEP){
+   tens_op->stage = TALSH_OP_STORED;
+   if(SHOW_PROGRESS)
+   printf("#DEBUG(talshTensorOpProgress): Stored tensor operation %p\n",tens_op); //debug
    if(CHECK_NORMS){
     snorm1 = talshTensorImageNorm1_cpu(tens_op->tens_slice[0].tensor);
-    printf("#DEBUG(talshTensorOpProgress): Tensor operation %p inserted 1-norm = %e\n",tens_op,snorm1-tnorm1);
+    printf("#DEBUG(talshTensorOpProgress): Tensor operation %p destination 1-norm = %e\n",tens_op,snorm1);
    }
    errc = talshTensorOpProgress(tens_op,done);
   }else{
-   if(errc != TRY_LATER && VERBOSE)
-   printf("#ERROR(talshTensorOpProgress): COMPLETED->STORED error %d for tensor operation %p\n",errc,tens_op);
+   if(errc != TALSH_SUCCESS && errc != TRY_LATER && VERBOSE)
+   printf("#ERROR(talshTensorOpProgress): STORING->STORED error %d for tensor operation %p\n",errc,tens_op);
   }
   break;
  case TALSH_OP_STORED:
@@ -3263,6 +3819,160 @@ int talshTensorOpDecompose2(         //out: error code
  return errc;
 }
 
+int talshTensorOpDecompose(          //out: error code
+    const talsh_tens_op_t * tens_op, //in: parent tensor operation (must be defined on entrance)
+    size_t arg_max,                  //in: max size of each tensor argument of a sub-operation (bytes)
+    size_t tot_max,                  //in: max total size of all tensor arguments of a sub-operation (bytes)
+    int max_ops,                     //in: max number of sub-operations
+    int * num_ops,                   //out: number of sub-operations
+    talsh_tens_op_t ** child_ops)    //inout: if not NULL, <num_ops> children tensor operations (must be empty on entrance)
+/** Decomposes a parent tensor operation into a k-way tiling of sub-operations (children operations)
+    such that the tensor arguments of each sub-operation fit the given memory limits. The tiling is
+    built greedily by splitting the index which shrinks the arguments most per unit of the increase
+    of the total slice traffic (the total byte count of all sub-operations), thus maximizing
+    the aggregate arithmetic intensity. Batch indices are split first since they cost no extra traffic,
+    contracted indices are split last since they cause output conflicts (accumulative stores).
+    The sub-operations are ordered such that neighbours share the larger input slice, whereas
+    sub-operations differing only in contracted tiles (sharing the output slice) are adjacent.
+    If <child_ops> is NULL, only the number of sub-operations <num_ops> is determined. **/
+{
+ const double OUT_WEIGHT = 2.0; //output slices are stored accumulatively (read and written)
+ int contr_ptrn[MAX_TENSOR_RANK*2],drank,lrank,rrank,conj_bits,dks,nind,nargs,large,best,n,errc;
+ int ipos[MAX_TENSOR_RANK*2][MAX_TENSOR_OPERANDS]; //position of each distinct index in each tensor argument (or -1)
+ int dind[MAX_TENSOR_RANK],lind[MAX_TENSOR_RANK],ord[MAX_TENSOR_RANK*2],key[MAX_TENSOR_RANK*2];
+ int dims[MAX_TENSOR_RANK];
+ size_t ext[MAX_TENSOR_RANK*2],seg[MAX_TENSOR_RANK*2],cnt[MAX_TENSOR_RANK*2],offs[MAX_TENSOR_RANK];
+ double vol[MAX_TENSOR_OPERANDS],viol,traf,nops;
+
+ if(tens_op == NULL || num_ops == NULL || max_ops <= 0 || arg_max == 0 || tot_max == 0) return TALSH_INVALID_ARGS;
+ *num_ops = 0;
+ if(tens_op->stage != TALSH_OP_DEFINED) return TALSH_NOT_ALLOWED;
+ if(talshValidDataKind(tens_op->data_kind,&dks) != YEP) return TALSH_INVALID_ARGS;
+ // Tiling cost model:
+ auto evaluate = [&](double * violation, double * traffic, double * count){ //memory limit violation, total traffic, number of sub-operations
+  double argsz,totsz = 0.0; *violation = 0.0; *traffic = 0.0; *count = 1.0;
+  for(int k = 0; k < nind; ++k) *count *= (double)(seg[k]);
+  for(int a = 0; a < nargs; ++a){
+   double rep = 1.0; argsz = (double)dks;
+   for(int k = 0; k < nind; ++k){
+    if(ipos[k][a] >= 0){argsz *= (double)((ext[k] + seg[k] - 1) / seg[k]);}else{rep *= (double)(seg[k]);}
+   }
+   *violation = MAX(*violation,argsz/((double)arg_max)); totsz += argsz;
+   *traffic += vol[a] * rep * ((a == 0) ? OUT_WEIGHT : 1.0);
+  }
+  *violation = MAX(*violation,totsz/((double)tot_max));
+  return;
+ };
+ errc = TALSH_SUCCESS;
+ switch(tens_op->opkind){
+  case TALSH_TENSOR_CONTRACT:
+   errc=talsh_get_contr_ptrn_str2dig(tens_op->symb_pattern,contr_ptrn,&drank,&lrank,&rrank,&conj_bits);
+   if(errc != TALSH_SUCCESS) break;
+   if(tens_op->num_args != 3){errc = TALSH_INVALID_ARGS; break;}
+   nargs = tens_op->num_args;
+   // Identify distinct indices and their positions in the tensor arguments:
+   nind = 0;
+   for(int i = 0; i < drank; ++i) dind[i] = -1;
+   for(int i = 0; i < lrank; ++i){
+    for(int a = 0; a < nargs; ++a) ipos[nind][a] = -1;
+    ipos[nind][1] = i; ext[nind] = tens_op->tens_slice[1].shape.dims[i];
+    if(contr_ptrn[i] > 0){ipos[nind][0] = contr_ptrn[i] - 1; dind[contr_ptrn[i] - 1] = nind;}
+    lind[i] = nind++;
+   }
+   for(int i = 0; i < rrank; ++i){
+    int j = contr_ptrn[lrank + i];
+    if(j > 0){
+     if(dind[j-1] >= 0){ //batch index
+      ipos[dind[j-1]][2] = i;
+     }else{ //right index
+      for(int a = 0; a < nargs; ++a) ipos[nind][a] = -1;
+      ipos[nind][0] = j - 1; ipos[nind][2] = i; ext[nind] = tens_op->tens_slice[2].shape.dims[i];
+      dind[j-1] = nind++;
+     }
+    }else if(j < 0){ //contracted index
+     ipos[lind[-j-1]][2] = i;
+    }
+   }
+   for(int i = 0; i < drank; ++i){ //indices present in the destination tensor only
+    if(dind[i] < 0){
+     for(int a = 0; a < nargs; ++a) ipos[nind][a] = -1;
+     ipos[nind][0] = i; ext[nind] = tens_op->tens_slice[0].shape.dims[i];
+     dind[i] = nind++;
+    }
+   }
+   for(int k = 0; k < nind; ++k) seg[k] = 1;
+   for(int a = 0; a < nargs; ++a) vol[a] = (double)(talshTensorSliceVolume(&(tens_op->tens_slice[a])));
+   // Greedy tiling:
+   evaluate(&viol,&traf,&nops);
+   while(viol > 1.0){
+    double vnew,tnew,onew,score,best_score = -1.0;
+    size_t best_seg = 0;
+    best = -1;
+    for(int k = 0; k < nind; ++k){
+     size_t til = (ext[k] + seg[k] - 1) / seg[k]; if(til <= 1) continue;
+     size_t s0 = seg[k], s1 = s0 + 1;
+     if((ext[k] + s1 - 1) / s1 >= til) s1 = (ext[k] + til - 2) / (til - 1); //next segment count that shrinks the tile
+     seg[k] = s1; evaluate(&vnew,&tnew,&onew); seg[k] = s0;
+     if(vnew >= viol || onew > (double)max_ops) continue;
+     double gain = log(viol/vnew), cost = log(tnew/traf);
+     if(cost > 0.0){score = gain/cost;}else{score = 1e300;} //free split (batch index)
+     if(score > best_score){best_score = score; best = k; best_seg = s1;}
+    }
+    if(best < 0){errc = TALSH_LIMIT_EXCEEDED; break;}
+    seg[best] = best_seg;
+    evaluate(&viol,&traf,&nops);
+   }
+   if(errc != TALSH_SUCCESS) break;
+   *num_ops = (int)nops;
+   //printf("#DEBUG(talshTensorOpDecompose): %d sub-operations: Intensity = %e\n",*num_ops,
+   //       talshTensorOpGetFlopCount(tens_op)/(traf*dks)); //debug
+   if(child_ops == NULL) break;
+   // Order indices (outer to inner): batch, larger input only, smaller input only, contracted:
+   large = 1; if(vol[2] > vol[1]) large = 2;
+   for(int k = 0; k < nind; ++k){
+    if(ipos[k][0] >= 0){
+     if(ipos[k][1] >= 0 && ipos[k][2] >= 0){key[k] = 0;}else if(ipos[k][large] >= 0){key[k] = 1;}else{key[k] = 2;}
+    }else{
+     key[k] = 3;
+    }
+   }
+   n = 0;
+   for(int kk = 0; kk <= 3; ++kk){for(int k = 0; k < nind; ++k){if(key[k] == kk) ord[n++] = k;}}
+   // Generate sub-operations (balanced segments):
+   for(int k = 0; k < nind; ++k) cnt[k] = 0;
+   for(int opn = 0; opn < *num_ops; ++opn){
+    talsh_tens_op_t * child = child_ops[opn];
+    if(child == NULL){errc = TALSH_INVALID_ARGS; break;}
+    for(int a = 0; a < nargs; ++a){
+     const talsh_tens_slice_t * slice = &(tens_op->tens_slice[a]);
+     int nd = talshTensorRank(slice->tensor);
+     for(int i = 0; i < nd; ++i){offs[i] = slice->bases.offsets[i]; dims[i] = slice->shape.dims[i];}
+     for(int k = 0; k < nind; ++k){
+      int i = ipos[k][a];
+      if(i >= 0){
+       size_t base = ext[k] / seg[k], rem = ext[k] % seg[k];
+       offs[i] += cnt[k] * base + MIN(cnt[k],rem);
+       dims[i] = (int)(base + ((cnt[k] < rem) ? 1 : 0));
+      }
+     }
+     errc = talshTensorOpSetArgument(child,slice->tensor,offs,dims); if(errc != TALSH_SUCCESS) break;
+    }
+    if(errc == TALSH_SUCCESS) errc = talshTensorOpSpecify(child,tens_op->opkind,tens_op->data_kind,
+                                      tens_op->symb_pattern,tens_op->alpha_real,tens_op->alpha_imag);
+    if(errc != TALSH_SUCCESS) break;
+    for(int m = n - 1; m >= 0; --m){ //next tile (innermost index runs fastest)
+     int k = ord[m];
+     if(++cnt[k] < seg[k]) break;
+     cnt[k] = 0;
+    }
+   }
+   break;
+  default:
+   errc=TALSH_NOT_IMPLEMENTED;
+ }
+ return errc;
+}
+
 void talshTensorOpPrint(const talsh_tens_op_t * tens_op)
 {
 #pragma omp flush
@@ -3537,11 +4247,12 @@ int talshTensorInit(talsh_tens_t * dtens,
                     talsh_task_t * talsh_task)
 /** Tensor initialization dispatcher **/
 {
- int j,devid,dvk,dvn,dimg,dcp,errc;
+ int j,devid,dvk,dvn,dimg,dcp,errc,native;
  unsigned int coh_ctrl,coh,cohd;
  talsh_task_t * tsk;
  host_task_t * host_task;
- void *dftr;
+ std::function<int()> host_op;
+ void *dftr=NULL;
  clock_t ctm;
 #ifndef NO_GPU
  cudaTask_t * cuda_task;
@@ -3621,10 +4332,14 @@ int talshTensorInit(talsh_tens_t * dtens,
  //Schedule the tensor operation via the device-kind specific runtime:
  switch(dvk){
   case DEV_HOST:
-   //Associate TAL-SH tensor images with <tensor_block_t> objects:
-   errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
-   if(errc || dftr == NULL){
-    tsk->task_error=111; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+   //Choose the CP-TAL implementation (native C++ for small tensors):
+   native=talsh_host_native(TALSH_TENSOR_INIT,dtens,dimg);
+   if(native == NOPE){
+    //Associate TAL-SH tensor images with <tensor_block_t> objects:
+    errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
+    if(errc || dftr == NULL){
+     tsk->task_error=111; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
    }
    //Get the Host task:
    host_task=(host_task_t*)(tsk->task_p);
@@ -3632,7 +4347,9 @@ int talshTensorInit(talsh_tens_t * dtens,
    //Discard all output images except the source one:
    errc=talsh_tensor_image_discard_other(dtens,dimg); //the only remaining image 0 is the source image
    if(errc != TALSH_SUCCESS){
-    j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    if(native == NOPE){
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
     j=host_task_record(host_task,coh_ctrl,13);
     j=host_task_destroy(host_task); tsk->task_p=NULL; if(j) errc=TALSH_FAILURE;
     tsk->task_error=112; if(talsh_task == NULL) j=talshTaskDestroy(tsk);
@@ -3640,16 +4357,30 @@ int talshTensorInit(talsh_tens_t * dtens,
    }
    //Mark soure images unavailable:
    dtens->avail[0] = NOPE;
+   //Tensor operation (dissociates <tensor_block_t> objects on exit):
+   host_op=[=]()->int{
+    int j,errc;
+    if(native != NOPE){
+     errc=talsh::cpu::tensor_image_init(dtens,0,val_real,val_imag,0); //`no conjugation bits
+    }else{
+     errc=cpu_tensor_block_init(dftr,val_real,val_imag,0); //`no conjugation bits
+     if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
+      j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
+      if(j) errc=TALSH_FAILURE;
+     }
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
+    return errc;
+   };
+   host_op=talsh_perf_timed(TALSH_TENSOR_INIT,talsh_perf_work(dtens),((native != NOPE) ? 1 : 0),host_op); //online performance model
    //Schedule tensor operation via the device-kind specific runtime:
-   ctm=clock();
-   errc=cpu_tensor_block_init(dftr,val_real,val_imag,0); //blocking call (`no conjugation bits)
-   if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
-    j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
-    if(j) errc=TALSH_FAILURE;
+   if(talsh_task != NULL){ //non-blocking call: Executed and finalized by the Host worker pool
+    errc=host_task_submit(host_task,coh_ctrl,dtens,host_op);
+    if(errc == TALSH_SUCCESS) break;
    }
+   ctm=clock();
+   errc=host_op(); //blocking call
    tsk->exec_time=((double)(clock()-ctm))/CLOCKS_PER_SEC;
-   //Dissociate <tensor_block_t> objects:
-   j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
    //Host task finalization and coherence control:
    if(errc){ //task error
     if(errc == TRY_LATER || errc == DEVICE_UNABLE){
@@ -3759,11 +4490,13 @@ int talshTensorSlice(talsh_tens_t * dtens, //inout: destination tensor block (te
                      talsh_task_t * talsh_task)
 /** Tensor slicing dispatcher **/
 {
- int j,devid,dvk,dvn,dimg,limg,dcp,lcp,errc;
+ int j,devid,dvk,dvn,dimg,limg,dcp,lcp,errc,native;
+ int offs[MAX_TENSOR_RANK];
  unsigned int coh_ctrl,coh,cohd,cohl;
  talsh_task_t * tsk;
  host_task_t * host_task;
- void *dftr,*lftr;
+ std::function<int()> host_op;
+ void *dftr=NULL,*lftr=NULL;
  clock_t ctm;
 #ifndef NO_GPU
  cudaTask_t * cuda_task;
@@ -3858,15 +4591,19 @@ int talshTensorSlice(talsh_tens_t * dtens, //inout: destination tensor block (te
  //Schedule the tensor operation via the device-kind specific runtime:
  switch(dvk){
   case DEV_HOST:
-   //Associate TAL-SH tensor images with <tensor_block_t> objects:
-   errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
-   if(errc || dftr == NULL){
-    tsk->task_error=114; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
-   }
-   errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
-   if(errc || lftr == NULL){
-    errc=talsh_tensor_f_dissoc(dftr);
-    tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+   //Choose the CP-TAL implementation (native C++ for small tensors):
+   native=talsh_host_native(TALSH_TENSOR_SLICE,dtens,dimg,ltens,limg);
+   if(native == NOPE){
+    //Associate TAL-SH tensor images with <tensor_block_t> objects:
+    errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
+    if(errc || dftr == NULL){
+     tsk->task_error=114; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
+    errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
+    if(errc || lftr == NULL){
+     errc=talsh_tensor_f_dissoc(dftr);
+     tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
    }
    //Get the Host task:
    host_task=(host_task_t*)(tsk->task_p);
@@ -3874,8 +4611,10 @@ int talshTensorSlice(talsh_tens_t * dtens, //inout: destination tensor block (te
    //Discard all output images except the source one:
    errc=talsh_tensor_image_discard_other(dtens,dimg); //the only remaining image 0 is the source image
    if(errc != TALSH_SUCCESS){
-    j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-    j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    if(native == NOPE){
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
     j=host_task_record(host_task,coh_ctrl,13);
     j=host_task_destroy(host_task); tsk->task_p=NULL; if(j) errc=TALSH_FAILURE;
     tsk->task_error=116; if(talsh_task == NULL) j=talshTaskDestroy(tsk);
@@ -3884,17 +4623,32 @@ int talshTensorSlice(talsh_tens_t * dtens, //inout: destination tensor block (te
    //Mark source images unavailable:
    dtens->avail[0] = NOPE;
    if(cohl == COPY_D || (cohl == COPY_M && ltens->dev_rsc[limg].dev_id != devid)) ltens->avail[limg] = NOPE;
+   for(j=0;j<talshTensorRank(dtens);++j) offs[j]=offsets[j]; //copy of the offsets kept by the tensor operation
+   //Tensor operation (dissociates <tensor_block_t> objects on exit):
+   host_op=[=]()->int{
+    int j,errc;
+    if(native != NOPE){
+     errc=talsh::cpu::tensor_image_slice(ltens,limg,dtens,0,offs,accumulative);
+    }else{
+     errc=cpu_tensor_block_slice(lftr,dftr,offs,accumulative);
+     if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
+      j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
+      if(j) errc=TALSH_FAILURE;
+     }
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
+    return errc;
+   };
+   host_op=talsh_perf_timed(TALSH_TENSOR_SLICE,talsh_perf_work(dtens,ltens),((native != NOPE) ? 1 : 0),host_op); //online performance model
    //Schedule tensor operation via the device-kind specific runtime:
-   ctm=clock();
-   errc=cpu_tensor_block_slice(lftr,dftr,offsets,accumulative); //blocking call
-   if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
-    j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
-    if(j) errc=TALSH_FAILURE;
+   if(talsh_task != NULL){ //non-blocking call: Executed and finalized by the Host worker pool
+    errc=host_task_submit(host_task,coh_ctrl,dtens,host_op,[=](){ltens->avail[limg] = YEP;});
+    if(errc == TALSH_SUCCESS) break;
    }
+   ctm=clock();
+   errc=host_op(); //blocking call
    tsk->exec_time=((double)(clock()-ctm))/CLOCKS_PER_SEC;
-   //Dissociate <tensor_block_t> objects:
-   j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-   j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
    //Host task finalization and coherence control:
    if(errc){ //task error
     if(errc == TRY_LATER || errc == DEVICE_UNABLE){
@@ -4020,11 +4774,13 @@ int talshTensorInsert(talsh_tens_t * dtens, //inout: destination tensor block
                       talsh_task_t * talsh_task)
 /** Tensor insertion dispatcher **/
 {
- int j,devid,dvk,dvn,dimg,limg,dcp,lcp,errc;
+ int j,devid,dvk,dvn,dimg,limg,dcp,lcp,errc,native;
+ int offs[MAX_TENSOR_RANK];
  unsigned int coh_ctrl,coh,cohd,cohl;
  talsh_task_t * tsk;
  host_task_t * host_task;
- void *dftr,*lftr;
+ std::function<int()> host_op;
+ void *dftr=NULL,*lftr=NULL;
  clock_t ctm;
 #ifndef NO_GPU
  cudaTask_t * cuda_task;
@@ -4119,15 +4875,19 @@ int talshTensorInsert(talsh_tens_t * dtens, //inout: destination tensor block
  //Schedule the tensor operation via the device-kind specific runtime:
  switch(dvk){
   case DEV_HOST:
-   //Associate TAL-SH tensor images with <tensor_block_t> objects:
-   errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
-   if(errc || dftr == NULL){
-    tsk->task_error=114; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
-   }
-   errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
-   if(errc || lftr == NULL){
-    errc=talsh_tensor_f_dissoc(dftr);
-    tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+   //Choose the CP-TAL implementation (native C++ for small tensors):
+   native=talsh_host_native(TALSH_TENSOR_INSERT,dtens,dimg,ltens,limg);
+   if(native == NOPE){
+    //Associate TAL-SH tensor images with <tensor_block_t> objects:
+    errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
+    if(errc || dftr == NULL){
+     tsk->task_error=114; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
+    errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
+    if(errc || lftr == NULL){
+     errc=talsh_tensor_f_dissoc(dftr);
+     tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
    }
    //Get the Host task:
    host_task=(host_task_t*)(tsk->task_p);
@@ -4135,8 +4895,10 @@ int talshTensorInsert(talsh_tens_t * dtens, //inout: destination tensor block
    //Discard all output images except the source one:
    errc=talsh_tensor_image_discard_other(dtens,dimg); //the only remaining image 0 is the source image
    if(errc != TALSH_SUCCESS){
-    j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-    j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    if(native == NOPE){
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
     j=host_task_record(host_task,coh_ctrl,13);
     j=host_task_destroy(host_task); tsk->task_p=NULL; if(j) errc=TALSH_FAILURE;
     tsk->task_error=116; if(talsh_task == NULL) j=talshTaskDestroy(tsk);
@@ -4145,17 +4907,32 @@ int talshTensorInsert(talsh_tens_t * dtens, //inout: destination tensor block
    //Mark source images unavailable:
    dtens->avail[0] = NOPE;
    if(cohl == COPY_D || (cohl == COPY_M && ltens->dev_rsc[limg].dev_id != devid)) ltens->avail[limg] = NOPE;
+   for(j=0;j<talshTensorRank(dtens);++j) offs[j]=offsets[j]; //copy of the offsets kept by the tensor operation
+   //Tensor operation (dissociates <tensor_block_t> objects on exit):
+   host_op=[=]()->int{
+    int j,errc;
+    if(native != NOPE){
+     errc=talsh::cpu::tensor_image_insert(ltens,limg,dtens,0,offs,accumulative);
+    }else{
+     errc=cpu_tensor_block_insert(lftr,dftr,offs,accumulative);
+     if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
+      j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
+      if(j) errc=TALSH_FAILURE;
+     }
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
+    return errc;
+   };
+   host_op=talsh_perf_timed(TALSH_TENSOR_INSERT,talsh_perf_work(dtens,ltens),((native != NOPE) ? 1 : 0),host_op); //online performance model
    //Schedule tensor operation via the device-kind specific runtime:
-   ctm=clock();
-   errc=cpu_tensor_block_insert(lftr,dftr,offsets,accumulative); //blocking call
-   if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
-    j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
-    if(j) errc=TALSH_FAILURE;
+   if(talsh_task != NULL){ //non-blocking call: Executed and finalized by the Host worker pool
+    errc=host_task_submit(host_task,coh_ctrl,dtens,host_op,[=](){ltens->avail[limg] = YEP;});
+    if(errc == TALSH_SUCCESS) break;
    }
+   ctm=clock();
+   errc=host_op(); //blocking call
    tsk->exec_time=((double)(clock()-ctm))/CLOCKS_PER_SEC;
-   //Dissociate <tensor_block_t> objects:
-   j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-   j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
    //Host task finalization and coherence control:
    if(errc){ //task error
     if(errc == TRY_LATER || errc == DEVICE_UNABLE){
@@ -4280,12 +5057,13 @@ int talshTensorCopy(const char * cptrn,   //in: tensor copy pattern
                     talsh_task_t * talsh_task)
 /** Tensor copy dispatcher **/
 {
- int j,devid,dvk,dvn,dimg,limg,dcp,lcp,errc;
+ int j,devid,dvk,dvn,dimg,limg,dcp,lcp,errc,native;
  int contr_ptrn[MAX_TENSOR_RANK],cpl,drnk,lrnk,rrnk,conj_bits;
  unsigned int coh_ctrl,coh,cohd,cohl;
  talsh_task_t * tsk;
  host_task_t * host_task;
- void *dftr,*lftr;
+ std::function<int()> host_op;
+ void *dftr=NULL,*lftr=NULL;
  clock_t ctm;
 #ifndef NO_GPU
  cudaTask_t * cuda_task;
@@ -4384,15 +5162,19 @@ int talshTensorCopy(const char * cptrn,   //in: tensor copy pattern
  //Schedule the tensor operation via the device-kind specific runtime:
  switch(dvk){
   case DEV_HOST:
-   //Associate TAL-SH tensor images with <tensor_block_t> objects:
-   errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
-   if(errc || dftr == NULL){
-    tsk->task_error=114; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
-   }
-   errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
-   if(errc || lftr == NULL){
-    errc=talsh_tensor_f_dissoc(dftr);
-    tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+   //Choose the CP-TAL implementation (native C++ for small tensors):
+   native=talsh_host_native(TALSH_TENSOR_COPY,dtens,dimg,ltens,limg);
+   if(native == NOPE){
+    //Associate TAL-SH tensor images with <tensor_block_t> objects:
+    errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
+    if(errc || dftr == NULL){
+     tsk->task_error=114; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
+    errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
+    if(errc || lftr == NULL){
+     errc=talsh_tensor_f_dissoc(dftr);
+     tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
    }
    //Get the Host task:
    host_task=(host_task_t*)(tsk->task_p);
@@ -4400,8 +5182,10 @@ int talshTensorCopy(const char * cptrn,   //in: tensor copy pattern
    //Discard all output images except the source one:
    errc=talsh_tensor_image_discard_other(dtens,dimg); //the only remaining image 0 is the source image
    if(errc != TALSH_SUCCESS){
-    j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-    j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    if(native == NOPE){
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
     j=host_task_record(host_task,coh_ctrl,13);
     j=host_task_destroy(host_task); tsk->task_p=NULL; if(j) errc=TALSH_FAILURE;
     tsk->task_error=116; if(talsh_task == NULL) j=talshTaskDestroy(tsk);
@@ -4410,17 +5194,31 @@ int talshTensorCopy(const char * cptrn,   //in: tensor copy pattern
    //Mark source images unavailable:
    dtens->avail[0] = NOPE;
    if(cohl == COPY_D || (cohl == COPY_M && ltens->dev_rsc[limg].dev_id != devid)) ltens->avail[limg] = NOPE;
+   //Tensor operation (dissociates <tensor_block_t> objects on exit):
+   host_op=[=]()->int{
+    int j,errc;
+    if(native != NOPE){
+     errc=talsh::cpu::tensor_image_add(contr_ptrn,ltens,limg,dtens,0,1.0,0.0,conj_bits,NOPE);
+    }else{
+     errc=cpu_tensor_block_copy(contr_ptrn,lftr,dftr,conj_bits);
+     if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
+      j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
+      if(j) errc=TALSH_FAILURE;
+     }
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
+    return errc;
+   };
+   host_op=talsh_perf_timed(TALSH_TENSOR_COPY,talsh_perf_work(dtens,ltens),((native != NOPE) ? 1 : 0),host_op); //online performance model
    //Schedule tensor operation via the device-kind specific runtime:
-   ctm=clock();
-   errc=cpu_tensor_block_copy(contr_ptrn,lftr,dftr,conj_bits); //blocking call
-   if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
-    j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
-    if(j) errc=TALSH_FAILURE;
+   if(talsh_task != NULL){ //non-blocking call: Executed and finalized by the Host worker pool
+    errc=host_task_submit(host_task,coh_ctrl,dtens,host_op,[=](){ltens->avail[limg] = YEP;});
+    if(errc == TALSH_SUCCESS) break;
    }
+   ctm=clock();
+   errc=host_op(); //blocking call
    tsk->exec_time=((double)(clock()-ctm))/CLOCKS_PER_SEC;
-   //Dissociate <tensor_block_t> objects:
-   j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-   j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
    //Host task finalization and coherence control:
    if(errc){ //task error
     if(errc == TRY_LATER || errc == DEVICE_UNABLE){
@@ -4547,12 +5345,13 @@ int talshTensorAdd(const char * cptrn,   //in: tensor addition pattern
                    talsh_task_t * talsh_task)
 /** Tensor addition dispatcher **/
 {
- int j,devid,dvk,dvn,dimg,limg,dcp,lcp,errc;
+ int j,devid,dvk,dvn,dimg,limg,dcp,lcp,errc,native;
  int contr_ptrn[MAX_TENSOR_RANK],cpl,drnk,lrnk,rrnk,conj_bits;
  unsigned int coh_ctrl,coh,cohd,cohl;
  talsh_task_t * tsk;
  host_task_t * host_task;
- void *dftr,*lftr;
+ std::function<int()> host_op;
+ void *dftr=NULL,*lftr=NULL;
  clock_t ctm;
  double tms;
 #ifndef NO_GPU
@@ -4659,15 +5458,20 @@ int talshTensorAdd(const char * cptrn,   //in: tensor addition pattern
  //Schedule the tensor operation via the device-kind specific runtime:
  switch(dvk){
   case DEV_HOST:
-   //Associate TAL-SH tensor images with <tensor_block_t> objects:
-   errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
-   if(errc || dftr == NULL){
-    tsk->task_error=114; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
-   }
-   errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
-   if(errc || lftr == NULL){
-    errc=talsh_tensor_f_dissoc(dftr);
-    tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+   //Choose the CP-TAL implementation (native C++ for small tensors):
+   native=talsh_host_native(TALSH_TENSOR_ADD,dtens,dimg,ltens,limg);
+   for(j=0; j<drnk; ++j){if(contr_ptrn[j] != j+1) native=YEP;} //permuted addition is only implemented natively
+   if(native == NOPE){
+    //Associate TAL-SH tensor images with <tensor_block_t> objects:
+    errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
+    if(errc || dftr == NULL){
+     tsk->task_error=114; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
+    errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
+    if(errc || lftr == NULL){
+     errc=talsh_tensor_f_dissoc(dftr);
+     tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
    }
    //Get the Host task:
    host_task=(host_task_t*)(tsk->task_p);
@@ -4675,8 +5479,10 @@ int talshTensorAdd(const char * cptrn,   //in: tensor addition pattern
    //Discard all output images except the source one:
    errc=talsh_tensor_image_discard_other(dtens,dimg); //the only remaining image 0 is the source image
    if(errc != TALSH_SUCCESS){
-    j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-    j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    if(native == NOPE){
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
     j=host_task_record(host_task,coh_ctrl,13);
     j=host_task_destroy(host_task); tsk->task_p=NULL; if(j) errc=TALSH_FAILURE;
     tsk->task_error=116; if(talsh_task == NULL) j=talshTaskDestroy(tsk);
@@ -4685,17 +5491,31 @@ int talshTensorAdd(const char * cptrn,   //in: tensor addition pattern
    //Mark source images unavailable:
    dtens->avail[0] = NOPE;
    if(cohl == COPY_D || (cohl == COPY_M && ltens->dev_rsc[limg].dev_id != devid)) ltens->avail[limg] = NOPE;
+   //Tensor operation (dissociates <tensor_block_t> objects on exit):
+   host_op=[=]()->int{
+    int j,errc;
+    if(native != NOPE){
+     errc=talsh::cpu::tensor_image_add(contr_ptrn,ltens,limg,dtens,0,scale_real,scale_imag,conj_bits,YEP);
+    }else{
+     errc=cpu_tensor_block_add(contr_ptrn,lftr,dftr,scale_real,scale_imag,conj_bits);
+     if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
+      j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
+      if(j) errc=TALSH_FAILURE;
+     }
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
+    return errc;
+   };
+   host_op=talsh_perf_timed(TALSH_TENSOR_ADD,talsh_perf_work(dtens,ltens),((native != NOPE) ? 1 : 0),host_op); //online performance model
    //Schedule tensor operation via the device-kind specific runtime:
-   ctm=clock();
-   errc=cpu_tensor_block_add(contr_ptrn,lftr,dftr,scale_real,scale_imag,conj_bits); //blocking call
-   if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //an explicit update is needed for scalar destinations
-    j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
-    if(j) errc=TALSH_FAILURE;
+   if(talsh_task != NULL){ //non-blocking call: Executed and finalized by the Host worker pool
+    errc=host_task_submit(host_task,coh_ctrl,dtens,host_op,[=](){ltens->avail[limg] = YEP;});
+    if(errc == TALSH_SUCCESS) break;
    }
+   ctm=clock();
+   errc=host_op(); //blocking call
    tsk->exec_time=((double)(clock()-ctm))/CLOCKS_PER_SEC;
-   //Dissociate <tensor_block_t> objects:
-   j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-   j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
    //Host task finalization and coherence control:
    if(errc){ //task error
     if(errc == TRY_LATER || errc == DEVICE_UNABLE){
@@ -4827,12 +5647,13 @@ int talshTensorContract(const char * cptrn,        //in: C-string: symbolic cont
                         talsh_task_t * talsh_task) //inout: TAL-SH task (must be clean on entrance)
 /** Tensor contraction dispatcher **/
 {
- int j,devid,dvk,dvn,dimg,limg,rimg,dcp,lcp,rcp,errc;
+ int j,devid,dvk,dvn,dimg,limg,rimg,dcp,lcp,rcp,errc,native;
  int contr_ptrn[MAX_TENSOR_RANK*2],cpl,drnk,lrnk,rrnk,conj_bits;
  unsigned int coh_ctrl,coh,cohd,cohl,cohr;
  talsh_task_t * tsk;
  host_task_t * host_task;
- void *dftr,*lftr,*rftr;
+ std::function<int()> host_op;
+ void *dftr=NULL,*lftr=NULL,*rftr=NULL;
  clock_t ctm;
  double tms;
 #ifndef NO_GPU
@@ -4954,20 +5775,24 @@ int talshTensorContract(const char * cptrn,        //in: C-string: symbolic cont
  //Schedule tensor operation via the device-kind specific runtime:
  switch(dvk){
   case DEV_HOST:
-   //Associate TAL-SH tensor images with <tensor_block_t> objects:
-   errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
-   if(errc || dftr == NULL){
-    tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
-   }
-   errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
-   if(errc || lftr == NULL){
-    errc=talsh_tensor_f_dissoc(dftr);
-    tsk->task_error=116; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
-   }
-   errc=talsh_tensor_f_assoc(rtens,rimg,&rftr);
-   if(errc || rftr == NULL){
-    errc=talsh_tensor_f_dissoc(lftr); errc=talsh_tensor_f_dissoc(dftr);
-    tsk->task_error=117; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+   //Choose the CP-TAL implementation (native C++ for small tensors):
+   native=talsh_host_native(TALSH_TENSOR_CONTRACT,dtens,dimg,ltens,limg,rtens,rimg);
+   if(native == NOPE){
+    //Associate TAL-SH tensor images with <tensor_block_t> objects:
+    errc=talsh_tensor_f_assoc(dtens,dimg,&dftr);
+    if(errc || dftr == NULL){
+     tsk->task_error=115; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
+    errc=talsh_tensor_f_assoc(ltens,limg,&lftr);
+    if(errc || lftr == NULL){
+     errc=talsh_tensor_f_dissoc(dftr);
+     tsk->task_error=116; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
+    errc=talsh_tensor_f_assoc(rtens,rimg,&rftr);
+    if(errc || rftr == NULL){
+     errc=talsh_tensor_f_dissoc(lftr); errc=talsh_tensor_f_dissoc(dftr);
+     tsk->task_error=117; if(talsh_task == NULL) j=talshTaskDestroy(tsk); return TALSH_FAILURE;
+    }
    }
    //Get the Host task:
    host_task=(host_task_t*)(tsk->task_p);
@@ -4975,9 +5800,11 @@ int talshTensorContract(const char * cptrn,        //in: C-string: symbolic cont
    //Discard all output images except the source one:
    errc=talsh_tensor_image_discard_other(dtens,dimg); //the only remaining image 0 is the source image
    if(errc != TALSH_SUCCESS){
-    j=talsh_tensor_f_dissoc(rftr); if(j) errc=TALSH_FAILURE;
-    j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-    j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    if(native == NOPE){
+     j=talsh_tensor_f_dissoc(rftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
     j=host_task_record(host_task,coh_ctrl,13);
     j=host_task_destroy(host_task); tsk->task_p=NULL; if(j) errc=TALSH_FAILURE;
     tsk->task_error=118; if(talsh_task == NULL) j=talshTaskDestroy(tsk);
@@ -4987,18 +5814,32 @@ int talshTensorContract(const char * cptrn,        //in: C-string: symbolic cont
    dtens->avail[0] = NOPE;
    if(cohl == COPY_D || (cohl == COPY_M && ltens->dev_rsc[limg].dev_id != devid)) ltens->avail[limg] = NOPE;
    if(cohr == COPY_D || (cohr == COPY_M && rtens->dev_rsc[rimg].dev_id != devid)) rtens->avail[rimg] = NOPE;
+   //Tensor operation (dissociates <tensor_block_t> objects on exit):
+   host_op=[=]()->int{
+    int j,errc;
+    if(native != NOPE){
+     errc=talsh::cpu::tensor_image_contract(contr_ptrn,ltens,limg,rtens,rimg,dtens,0,scale_real,scale_imag,conj_bits,accumulative);
+    }else{
+     errc=cpu_tensor_block_contract(contr_ptrn,lftr,rftr,dftr,scale_real,scale_imag,conj_bits,accumulative);
+     if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //explicit update is needed for scalar destinations
+      j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
+      if(j) errc=TALSH_FAILURE;
+     }
+     j=talsh_tensor_f_dissoc(rftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
+     j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
+    }
+    return errc;
+   };
+   host_op=talsh_perf_timed(TALSH_TENSOR_CONTRACT,talsh_perf_work(dtens,ltens,rtens),((native != NOPE) ? 1 : 0),host_op); //online performance model
    //Schedule tensor operation via the device-kind specific runtime:
-   ctm=clock();
-   errc=cpu_tensor_block_contract(contr_ptrn,lftr,rftr,dftr,scale_real,scale_imag,conj_bits,accumulative); //blocking call
-   if(errc == TALSH_SUCCESS && talshTensorRank(dtens) == 0){ //explicit update is needed for scalar destinations
-    j=talsh_update_f_scalar(dftr,dtens->data_kind[0],dtens->dev_rsc[0].gmem_p);
-    if(j) errc=TALSH_FAILURE;
+   if(talsh_task != NULL){ //non-blocking call: Executed and finalized by the Host worker pool
+    errc=host_task_submit(host_task,coh_ctrl,dtens,host_op,[=](){ltens->avail[limg] = YEP; rtens->avail[rimg] = YEP;});
+    if(errc == TALSH_SUCCESS) break;
    }
+   ctm=clock();
+   errc=host_op(); //blocking call
    tsk->exec_time=((double)(clock()-ctm))/CLOCKS_PER_SEC;
-   //Dissociate <tensor_block_t> objects:
-   j=talsh_tensor_f_dissoc(rftr); if(j) errc=TALSH_FAILURE;
-   j=talsh_tensor_f_dissoc(lftr); if(j) errc=TALSH_FAILURE;
-   j=talsh_tensor_f_dissoc(dftr); if(j) errc=TALSH_FAILURE;
    //Host task finalization and coherence control:
    if(errc){ //task error
     if(errc == TRY_LATER || errc == DEVICE_UNABLE){
@@ -5087,6 +5928,7 @@ int talshTensorContract(const char * cptrn,        //in: C-string: symbolic cont
     tsk->task_error=127; if(talsh_task == NULL) j=talshTaskDestroy(tsk);
     return errc;
    }
+   tsk->flops=talsh_perf_work(dtens,ltens,rtens); //recorded in the online performance model upon completion
    //If blocking call, complete it here:
    if(errc == TALSH_SUCCESS && talsh_task == NULL){
     errc=talshTaskWait(tsk,&j); if(errc == TALSH_SUCCESS && j != TALSH_TASK_COMPLETED) errc=TALSH_TASK_ERROR;
@@ -5147,11 +5989,12 @@ int talshTensorContractXL(const char * cptrn,   //in: C-string: symbolic contrac
 /** Extra large tensor contraction dispatcher **/
 {
  const int MAX_ACTIVE = 2;      //max number of simultaneously active tensor operations per device
+ const int MAX_ACTIVE_HOST = 3; //max number of simultaneously active tensor operations on Host (pipeline: load, execute, store)
  const int MAX_TENS_OPS = 8192; //max total number of derived tensor operations
  int dims[MAX_TENSOR_RANK],data_kinds[TALSH_MAX_DEV_PRESENT];
- int errc,ier,n,dtk,max_ops,num_dec,inlen,oulen,wid,beg,fin,done,dev_beg,dev_end;
- size_t offs[MAX_TENSOR_RANK],totmem,argmem,dsz,lsz,rsz;
- talsh_tens_op_t *op,**que,**inq,**ouq,**swp;
+ int errc,ier,n,dtk,max_ops,max_act,num_dec,inlen,wid,beg,fin,done,dev_beg,dev_end,storing;
+ size_t offs[MAX_TENSOR_RANK],totmem,argmem,dsz;
+ talsh_tens_op_t gpop,*op,**inq;
  slab_t *op_stack;
  void *ptr;
  double tm;
@@ -5205,7 +6048,7 @@ int talshTensorContractXL(const char * cptrn,   //in: C-string: symbolic contrac
  }
  tm = time_sys_sec() - tm;
  //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Placed tensor arguments on Host\n",tm); //debug
- // Create temporary storage (slab) for tensor operations:
+ // Decompose the tensor contraction into tensor operations and execute them:
  if(errc == TALSH_SUCCESS){
   tm = time_sys_sec();
   dtk = data_kinds[0]; //destination tensor data kind defines execution data kind
@@ -5215,171 +6058,150 @@ int talshTensorContractXL(const char * cptrn,   //in: C-string: symbolic contrac
    dsz = talshDeviceBufferSize(i,dev_kind); if(dsz < totmem) totmem = dsz;
    dsz = talshDeviceTensorSize(i,dev_kind); if(dsz < argmem) argmem = dsz;
   }
-  max_ops = MAX_TENS_OPS; //`Determine precisely
+  max_act = MAX_ACTIVE; if(dev_kind == DEV_HOST) max_act = MAX_ACTIVE_HOST;
   //printf(" #DEBUG(talshTensorContractXL): Data kind = %d; ArgMemLim = %lu; TotMemLim = %lu\n",dtk,argmem,totmem); //debug
-  errc = slab_create(&op_stack);
-  if(errc == 0){
-   errc = slab_construct(op_stack,sizeof(talsh_tens_op_t),(size_t)max_ops);
+  // Create the grand-parental tensor operation:
+  errc = talshTensorOpClean(&gpop);
+  if(errc == TALSH_SUCCESS){
+   for(int i = 0; i < talshTensorRank(dtens); ++i) offs[i] = 0;
+   if(errc == TALSH_SUCCESS) errc = talshTensorOpSetArgument(&gpop,dtens,offs,dtens->shape_p->dims);
+   for(int i = 0; i < talshTensorRank(ltens); ++i) offs[i] = 0;
+   if(errc == TALSH_SUCCESS) errc = talshTensorOpSetArgument(&gpop,ltens,offs,ltens->shape_p->dims);
+   for(int i = 0; i < talshTensorRank(rtens); ++i) offs[i] = 0;
+   if(errc == TALSH_SUCCESS) errc = talshTensorOpSetArgument(&gpop,rtens,offs,rtens->shape_p->dims);
+   if(errc == TALSH_SUCCESS) errc = talshTensorOpSpecify(&gpop,TALSH_TENSOR_CONTRACT,dtk,cptrn,scale_real,scale_imag);
+   // Plan the decomposition of the grand-parental tensor operation (6 arguments per active contraction):
+   if(errc == TALSH_SUCCESS) errc = talshTensorOpDecompose(&gpop,argmem,totmem/(6*max_act+1),MAX_TENS_OPS,&max_ops);
+   if(errc != TALSH_SUCCESS){
+    if(VERBOSE) printf("#ERROR(talshTensorContractXL): Tensor operation decomposition planning error %d\n",errc);
+   }
+  }
+  tm = time_sys_sec() - tm;
+  //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Planned decomposition: %d tensor operations\n",tm,max_ops); //debug
+  if(errc == TALSH_SUCCESS){
+   tm = time_sys_sec();
+   errc = slab_create(&op_stack);
    if(errc == 0){
-    que = (talsh_tens_op_t**)malloc(sizeof(talsh_tens_op_t*)*max_ops*2);
-    if(que != NULL){
-     inq = &(que[0]); ouq = &(que[max_ops]);
-     inlen = 0; oulen = 0;
-     tm = time_sys_sec() - tm;
-     //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Allocated tensor operation storage: %d\n",tm,max_ops); //debug
-     // Create the grand-parental tensor operation:
-     tm = time_sys_sec();
-     errc = slab_entry_get(op_stack,&ptr);
-     if(errc == 0){
-      op = (talsh_tens_op_t*)ptr;
-      errc = talshTensorOpClean(op);
+    errc = slab_construct(op_stack,sizeof(talsh_tens_op_t),(size_t)max_ops);
+    if(errc == 0){
+     inq = (talsh_tens_op_t**)malloc(sizeof(talsh_tens_op_t*)*max_ops);
+     if(inq != NULL){
+      inlen = 0;
+      for(int opn = 0; opn < max_ops; ++opn){
+       errc = slab_entry_get(op_stack,&ptr); if(errc != 0){errc = TALSH_FAILURE; break;}
+       inq[inlen++] = (talsh_tens_op_t*)ptr;
+       errc = talshTensorOpClean(inq[opn]); if(errc != TALSH_SUCCESS) break;
+      }
+      tm = time_sys_sec() - tm;
+      //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Allocated tensor operation storage: %d\n",tm,max_ops); //debug
+      // Decompose the grand-parental tensor operation into descendant tensor operations:
+      if(errc == TALSH_SUCCESS){
+       tm = time_sys_sec();
+       errc = talshTensorOpDecompose(&gpop,argmem,totmem/(6*max_act+1),max_ops,&n,inq);
+       if(errc == TALSH_SUCCESS && n != max_ops) errc = TALSH_FAILURE;
+       if(errc != TALSH_SUCCESS){
+        if(VERBOSE) printf("#ERROR(talshTensorContractXL): Tensor operation decomposition error %d\n",errc);
+       }
+      }
+      // Execute all generated tensor operations:
       if(errc == TALSH_SUCCESS){
-       for(int i = 0; i < talshTensorRank(dtens); ++i) offs[i] = 0;
-       if(errc == TALSH_SUCCESS) errc = talshTensorOpSetArgument(op,dtens,offs,dtens->shape_p->dims);
-       for(int i = 0; i < talshTensorRank(ltens); ++i) offs[i] = 0;
-       if(errc == TALSH_SUCCESS) errc = talshTensorOpSetArgument(op,ltens,offs,ltens->shape_p->dims);
-       for(int i = 0; i < talshTensorRank(rtens); ++i) offs[i] = 0;
-       if(errc == TALSH_SUCCESS) errc = talshTensorOpSetArgument(op,rtens,offs,rtens->shape_p->dims);
-       if(errc == TALSH_SUCCESS) errc = talshTensorOpSpecify(op,TALSH_TENSOR_CONTRACT,dtk,cptrn,scale_real,scale_imag);
+       tm = time_sys_sec() - tm;
+       //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Decomposition length = %d\n",tm,inlen); //debug
+       // Chain neighbouring tensor operations with the same output slice (output-stationary accumulation):
+       tm = time_sys_sec();
+       for(int opn = 1; opn < inlen; ++opn){
+        errc = talshTensorOpChainOutput(inq[opn],inq[opn-1]);
+        if(errc == TALSH_INVALID_ARGS) errc = TALSH_SUCCESS; //different output slices
+        if(errc != TALSH_SUCCESS) break;
+       }
+       // Set execution device for all tensor operations (the same for chained tensor operations):
+       dev_id = dev_beg;
+       for(int opn = 0; opn < inlen && errc == TALSH_SUCCESS; ++opn){
+        if(opn > 0 && inq[opn]->out_prev == NULL){if(++dev_id > dev_end) dev_id = dev_beg;}
+        errc = talshTensorOpSetExecDevice(inq[opn],dev_id,dev_kind); if(errc != TALSH_SUCCESS) break;
+        //talshTensorOpPrint(inq[opn]); //debug
+       }
+       // Execute all tensor operations:
        if(errc == TALSH_SUCCESS){
-        inq[inlen++] = op;
-        num_dec = 1;
-        tm = time_sys_sec() - tm;
-        //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Created grand-parental tensor operation\n",tm); //debug
-        // Decompose the grand-parental tensor operation into descendant tensor operations:
-        tm = time_sys_sec();
-        while(num_dec > 0){
-         //printf(" #DEBUG(talshTensorContractXL): Started decomposition cycle: Length = %d\n",inlen); //debug
-         oulen = 0; num_dec = 0;
-         // Decompose:
-         for(int opn = 0; opn < inlen; ++opn){
-          op = inq[opn];
-          dsz = talshTensorOpGetArgSize(op,0);
-          lsz = talshTensorOpGetArgSize(op,1);
-          rsz = talshTensorOpGetArgSize(op,2);
-          if(dsz == 0 || lsz == 0 || rsz == 0){errc = TALSH_FAILURE; break;}
-          if(dsz > argmem || lsz > argmem || rsz > argmem || (dsz+lsz+rsz)*13 > totmem){ //need to decompose further (13 = 12: Pipeline for 2 contractions)
-           // Get new talsh_tens_op_t:
-           errc = slab_entry_get(op_stack,&ptr); if(errc != TALSH_SUCCESS) break;
-           ouq[oulen] = (talsh_tens_op_t*)ptr;
-           errc = talshTensorOpClean(ouq[oulen]); if(errc != TALSH_SUCCESS) break;
-           // Get new talsh_tens_op_t:
-           errc = slab_entry_get(op_stack,&ptr); if(errc != TALSH_SUCCESS) break;
-           ouq[oulen+1] = (talsh_tens_op_t*)ptr;
-           errc = talshTensorOpClean(ouq[oulen+1]); if(errc != TALSH_SUCCESS) break;
-           // Decompose parent tensor operation, creating two children:
-           errc = talshTensorOpDecompose2(op,ouq[oulen],ouq[oulen+1]);
-           if(errc == TALSH_SUCCESS){
-            oulen += 2;
+        if(accumulative != YEP) errc=talshTensorInit(dtens,0.0,0.0,0,DEV_HOST);
+        if(errc == TALSH_SUCCESS){
+         //printf(" #DEBUG(talshTensorContractXL): Executing %d tensor operations\n",inlen); fflush(stdout); //debug
+         wid = max_act * (dev_end - dev_beg + 1);
+         beg = 0; fin = MIN(beg+wid,inlen);
+         num_dec = inlen; //number of unfinished tensor operations
+         storing = -1; //tensor operation storing its output slice (output slices may overlap, thus are stored one at a time)
+         while(errc == TALSH_SUCCESS && num_dec > 0){
+          int opn = beg;
+          while(errc == TALSH_SUCCESS && opn < fin){
+           op = inq[opn];
+           if(storing >= 0 && storing != opn && op->out_next != YEP &&
+              (op->stage == TALSH_OP_SCHEDULED || op->stage == TALSH_OP_COMPLETED)){
+            ier = TALSH_SUCCESS; //wait for the store slot
+            if(op->stage == TALSH_OP_SCHEDULED) ier = talshTensorOpTest(op,&done,NOPE);
+            done = NOPE;
            }else{
-            if(VERBOSE) printf("#ERROR(talshTensorContractXL): Tensor operation %d decomposition error %d\n",opn,errc);
-            break;
-           }
-           // Destruct parent tensor operation and release its storage:
-           errc = talshTensorOpDestruct(op);
-           if(errc != TALSH_SUCCESS){
-            if(VERBOSE) printf("#ERROR(talshTensorContractXL): Tensor operation %d destruction error %d\n",opn,errc);
-            break;
+            ier = talshTensorOpProgress(op,&done);
+            if(op->stage == TALSH_OP_STORING){storing = opn;}else if(storing == opn){storing = -1;}
            }
-           errc = slab_entry_release(op_stack,(void*)op); op = NULL; inq[opn] = NULL;
-           if(errc == 0){++num_dec;}else{errc = TALSH_FAILURE; break;}
-          }else{ //no further decomposition needed
-           ouq[oulen++] = inq[opn]; inq[opn] = NULL; op = NULL; //simple move
-          }
-         }
-         if(errc != TALSH_SUCCESS) break;
-         //printf(" #DEBUG(talshTensorContractXL): Finished decomposition cycle: Length = %d\n",oulen); //debug
-         // Swap input with output:
-         swp = inq; inq = ouq; ouq = swp;
-         inlen = oulen; oulen = 0;
-        } //inq[0:inlen-1] will contain operation to execute
-        // Execute all generated tensor operations:
-        if(errc == TALSH_SUCCESS){
-         tm = time_sys_sec() - tm;
-         //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Decomposition length = %d\n",tm,inlen); //debug
-         // Set execution device for all tensor operations:
-         tm = time_sys_sec();
-         dev_id = dev_beg;
-         for(int opn = 0; opn < inlen; ++opn){
-          errc = talshTensorOpSetExecDevice(inq[opn],dev_id,dev_kind); if(errc != TALSH_SUCCESS) break;
-          //talshTensorOpPrint(inq[opn]); //debug
-          if(++dev_id > dev_end) dev_id = dev_beg;
-         }
-         // Execute all tensor operations:
-         if(errc == TALSH_SUCCESS){
-          if(accumulative != YEP) errc=talshTensorInit(dtens,0.0,0.0,0,DEV_HOST);
-          if(errc == TALSH_SUCCESS){
-           //printf(" #DEBUG(talshTensorContractXL): Executing %d tensor operations\n",inlen); fflush(stdout); //debug
-           wid = MAX_ACTIVE * (dev_end - dev_beg + 1);
-           beg = 0; fin = MIN(beg+wid,inlen);
-           num_dec = inlen; //number of unfinished tensor operations
-           while(errc == TALSH_SUCCESS && num_dec > 0){
-            int opn = beg;
-            while(errc == TALSH_SUCCESS && opn < fin){
-             ier = talshTensorOpProgress(inq[opn],&done);
-             if(ier == TALSH_SUCCESS){
-              if(done == YEP){
-               if(opn == beg){
-                --num_dec;
-                ++beg; fin = MIN(beg+wid,inlen); opn = fin - 2;
-               }
-              }
-             }else{
-              if(ier != TRY_LATER){
-               if(VERBOSE) printf("#ERROR(talshTensorContractXL): Tensor operation %d progress error %d at stage %d\n",
-                                  opn,ier,inq[opn]->stage);
-               errc = TALSH_FAILURE;
-              }
+           if(ier == TALSH_SUCCESS){
+            if(done == YEP){
+             if(opn == beg){
+              --num_dec;
+              ++beg; fin = MIN(beg+wid,inlen); opn = fin - 2;
              }
-             ++opn;
+            }
+           }else{
+            if(ier != TRY_LATER){
+             if(VERBOSE) printf("#ERROR(talshTensorContractXL): Tensor operation %d progress error %d at stage %d\n",
+                                opn,ier,inq[opn]->stage);
+             errc = TALSH_FAILURE;
             }
            }
-          }else{
-           if(VERBOSE) printf("#ERROR(talshTensorContractXL): talshTensorInit error %d\n",errc);
+           ++opn;
           }
+          if(dev_kind == DEV_HOST) std::this_thread::yield(); //leave the cores to the Host workers
          }
-         tm = time_sys_sec() - tm;
-         //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Executed %d tensor operations\n",tm,inlen); //debug
-        }
-        // Destruct all (presumably executed) tensor operations:
-        tm = time_sys_sec();
-        for(int opn = inlen - 1; opn >= 0; --opn){
-         ier = talshTensorOpDestruct(inq[opn]);
-         if(ier != TALSH_SUCCESS && errc == TALSH_SUCCESS){
-          if(VERBOSE) printf("#ERROR(talshTensorContractXL): talshTensorOpDestruct error %d for operation #%d\n",ier,opn);
-          errc = TALSH_FAILURE;
-         }
-         ier = slab_entry_release(op_stack,(void*)(inq[opn])); inq[opn] = NULL;
-         if(ier != 0 && errc == TALSH_SUCCESS){
-          if(VERBOSE) printf("#ERROR(talshTensorContractXL): slab_entry_release error %d for operation #%d\n",ier,opn);
-          errc = TALSH_FAILURE;
-         }
+        }else{
+         if(VERBOSE) printf("#ERROR(talshTensorContractXL): talshTensorInit error %d\n",errc);
         }
-        tm = time_sys_sec() - tm;
-        //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Destructed %d tensor operations\n",tm,inlen); //debug
-       }else{
-        ier = talshTensorOpDestruct(op);
-        ier = slab_entry_release(op_stack,(void*)op);
        }
-      }else{
-       ier = slab_entry_release(op_stack,(void*)op);
+       tm = time_sys_sec() - tm;
+       //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Executed %d tensor operations\n",tm,inlen); //debug
       }
+      // Destruct all (presumably executed) tensor operations:
+      tm = time_sys_sec();
+      for(int opn = inlen - 1; opn >= 0; --opn){
+       ier = talshTensorOpDestruct(inq[opn]);
+       if(ier != TALSH_SUCCESS && errc == TALSH_SUCCESS){
+        if(VERBOSE) printf("#ERROR(talshTensorContractXL): talshTensorOpDestruct error %d for operation #%d\n",ier,opn);
+        errc = TALSH_FAILURE;
+       }
+       ier = slab_entry_release(op_stack,(void*)(inq[opn])); inq[opn] = NULL;
+       if(ier != 0 && errc == TALSH_SUCCESS){
+        if(VERBOSE) printf("#ERROR(talshTensorContractXL): slab_entry_release error %d for operation #%d\n",ier,opn);
+        errc = TALSH_FAILURE;
+       }
+      }
+      tm = time_sys_sec() - tm;
+      //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Destructed %d tensor operations\n",tm,inlen); //debug
+      free(inq); inq = NULL;
+     }else{
+      errc = TRY_LATER;
      }
-     free(que); que = NULL;
-    }else{
-     errc = TRY_LATER;
     }
+    // Destroy temporary storage for tensor operations:
+    tm = time_sys_sec();
+    ier = slab_destroy(op_stack);
+    if(ier != 0 && errc == TALSH_SUCCESS){
+     if(VERBOSE) printf("#ERROR(talshTensorContractXL): slab_destroy error %d\n",ier);
+     errc = TALSH_FAILURE;
+    }
+    tm = time_sys_sec() - tm;
+    //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Destroyed tensor operation storage\n",tm); //debug
    }
-   // Destroy temporary storage for tensor operations:
-   tm = time_sys_sec();
-   ier = slab_destroy(op_stack);
-   if(ier != 0 && errc == TALSH_SUCCESS){
-    if(VERBOSE) printf("#ERROR(talshTensorContractXL): slab_destroy error %d\n",ier);
-    errc = TALSH_FAILURE;
-   }
-   tm = time_sys_sec() - tm;
-   //printf(" #DEBUG(talshTensorContractXL)[%.4f]: Destroyed tensor operation storage\n",tm); //debug
   }
+  ier = talshTensorOpDestruct(&gpop);
+  if(ier != TALSH_SUCCESS && errc == TALSH_SUCCESS) errc = TALSH_FAILURE;
  }
  //printf("#DEBUG(talshTensorContractXL): Exited with status %d\n",errc); //debug
  return errc;
@@ -5391,6 +6213,174 @@ int talshTensorContractXL_(const char * cptrn, talsh_tens_t * dtens, talsh_tens_
  return talshTensorContractXL(cptrn,dtens,ltens,rtens,scale_real,scale_imag,dev_id,dev_kind,accumulative);
 }
 
+static int talsh_tensor_batch(int opkind,            //in: tensor operation kind: {TALSH_TENSOR_ADD,TALSH_TENSOR_CONTRACT}
+                              const char * cptrn,    //in: C-string: symbolic index pattern shared by all tensor operations
+                              int num_ops,           //in: number of tensor operations in the batch
+                              talsh_tens_t * dtens[], //inout: destination tensor blocks
+                              talsh_tens_t * ltens[], //inout: left source tensor blocks
+                              talsh_tens_t * rtens[], //inout: right source tensor blocks (tensor contractions only)
+                              double scale_real,     //in: scaling value (real part)
+                              double scale_imag,     //in: scaling value (imaginary part)
+                              int accumulative)      //in: accumulate in VS overwrite destination tensors: [YEP|NOPE]
+/** Executes a batch of tensor operations of the same kind sharing the same index pattern (blocking).
+    The index pattern is parsed and all tensor arguments are checked once before any tensor operation
+    is executed. Tensor operations processed by the native C++ CP-TAL on available Host images are
+    grouped by their destination tensor (a group is executed by a single thread in the batch order),
+    the groups are ordered by shape and executed in a single parallel sweep without constructing
+    TAL-SH tasks. The remaining tensor operations, as well as all tensor operations of a batch with
+    inter-operation dependencies (a source tensor is a destination of the same batch), are executed
+    one by one in the batch order by the regular tensor operation dispatcher. **/
+{
+ int i,j,k,errc,drnk,lrnk,rrnk,conj_bits,host,ntens;
+ int contr_ptrn[MAX_TENSOR_RANK*2],ranks[3];
+
+#pragma omp flush
+ if(talsh_on == 0) return TALSH_NOT_INITIALIZED;
+ if(cptrn == NULL || num_ops < 0) return TALSH_INVALID_ARGS;
+ if(num_ops == 0) return TALSH_SUCCESS;
+ ntens=3; if(opkind == TALSH_TENSOR_ADD) ntens=2;
+ if(dtens == NULL || ltens == NULL || (ntens == 3 && rtens == NULL)) return TALSH_INVALID_ARGS;
+ //Parse the index correspondence pattern (once):
+ errc=talsh_get_contr_ptrn_str2dig(cptrn,contr_ptrn,&drnk,&lrnk,&rrnk,&conj_bits);
+ if(errc) return TALSH_INVALID_ARGS;
+ ranks[0]=drnk; ranks[1]=lrnk; ranks[2]=rrnk;
+ //Check the tensor arguments and find dependencies:
+ std::vector<const talsh_tens_t*> dests(dtens,dtens+num_ops);
+ std::sort(dests.begin(),dests.end(),std::less<const talsh_tens_t*>());
+ bool dependent=false;
+ for(i=0;i<num_ops;++i){
+  for(k=0;k<ntens;++k){
+   const talsh_tens_t * tens=((k == 0) ? dtens[i] : ((k == 1) ? ltens[i] : rtens[i]));
+   if(tens == NULL) return TALSH_INVALID_ARGS;
+   if(talshTensorIsEmpty(tens) != NOPE) return TALSH_OBJECT_IS_EMPTY;
+   if(talshTensorIsHealthy(tens) != YEP) return TALSH_FAILURE;
+   if(talshTensorRank(tens) != ranks[k]) return TALSH_INVALID_ARGS;
+   if(k > 0 && std::binary_search(dests.begin(),dests.end(),tens,std::less<const talsh_tens_t*>())) dependent=true;
+  }
+ }
+ //Find the Host images processed by the native C++ CP-TAL:
+ auto shape_cmp=[&](int a, int b)->int{ //compares the shapes of two tensor operations
+  for(int n=0;n<ntens;++n){
+   const talsh_tens_t * ta=((n == 0) ? dtens[a] : ((n == 1) ? ltens[a] : rtens[a]));
+   const talsh_tens_t * tb=((n == 0) ? dtens[b] : ((n == 1) ? ltens[b] : rtens[b]));
+   for(int l=0;l<ranks[n];++l){
+    if(ta->shape_p->dims[l] != tb->shape_p->dims[l]) return ((ta->shape_p->dims[l] < tb->shape_p->dims[l]) ? -1 : 1);
+   }
+  }
+  return 0;
+ };
+ std::vector<int> images(num_ops*3,-1); //Host image of each tensor argument of each tensor operation (-1: regular dispatch)
+ std::vector<int> order(num_ops);       //tensor operations ordered by destination
+ host=talshFlatDevId(DEV_HOST,0);
+ int prev=-1,prev_datk=NO_TYPE,prev_native=NOPE; //CP-TAL implementation chosen for the previous shape and data kind
+ for(i=0;i<num_ops;++i){
+  order[i]=i;
+  if(dependent) continue;
+  talsh_tens_t * tens[]={dtens[i],ltens[i],((ntens == 3) ? rtens[i] : NULL)};
+  int * imgs=&(images[i*3]);
+  for(k=0;k<ntens;++k){
+   if(talshTensorInUse(tens[k]) != NOPE) break;
+   for(j=0;j<tens[k]->ndev;++j){ //available Host images only, source images must have the data kind of the destination image
+    if(tens[k]->dev_rsc[j].dev_id == host && tens[k]->avail[j] == YEP &&
+       (k == 0 || tens[k]->data_kind[j] == tens[0]->data_kind[imgs[0]])){
+     imgs[k]=j; break;
+    }
+   }
+   if(imgs[k] < 0) break;
+  }
+  if(k < ntens){imgs[0]=-1; continue;}
+  if(prev < 0 || tens[0]->data_kind[imgs[0]] != prev_datk || shape_cmp(i,prev) != 0){
+   prev=i; prev_datk=tens[0]->data_kind[imgs[0]];
+   prev_native=talsh_host_native(opkind,tens[0],imgs[0],tens[1],imgs[1],tens[2],imgs[2]);
+  }
+  if(prev_native != YEP) imgs[0]=-1;
+ }
+ //Group tensor operations by destination and order the groups by shape:
+ std::stable_sort(order.begin(),order.end(),[&](int a, int b){return std::less<const talsh_tens_t*>()(dtens[a],dtens[b]);});
+ std::vector<int> groups,group_end; //range of each group of native tensor operations in <order>
+ std::vector<int> others;           //tensor operations executed by the regular dispatcher
+ for(i=0;i<num_ops;i=j){
+  bool native=true;
+  for(j=i;j<num_ops && dtens[order[j]] == dtens[order[i]];++j) if(images[order[j]*3] < 0) native=false;
+  if(native){
+   groups.push_back(i); group_end.push_back(j);
+  }else{
+   for(k=i;k<j;++k) others.push_back(order[k]);
+  }
+ }
+ std::vector<int> sweep(groups.size());
+ for(i=0;i<(int)sweep.size();++i) sweep[i]=i;
+ std::stable_sort(sweep.begin(),sweep.end(),[&](int a, int b){return (shape_cmp(order[groups[a]],order[groups[b]]) < 0);});
+ //Discard all destination images except the Host one:
+ for(i=0;i<(int)groups.size();++i){
+  const int op=order[groups[i]];
+  errc=talsh_tensor_image_discard_other(dtens[op],images[op*3]); //the only remaining image 0 is the Host image
+  if(errc != TALSH_SUCCESS) return TALSH_FAILURE;
+ }
+ //Execute the native tensor operations in a single parallel sweep over the groups:
+ errc=TALSH_SUCCESS;
+ const int num_groups=sweep.size();
+#pragma omp parallel for schedule(guided) if(num_groups > 1)
+ for(int g=0;g<num_groups;++g){
+  for(int n=groups[sweep[g]];n<group_end[sweep[g]];++n){
+   const int op=order[n];
+   const int * imgs=&(images[op*3]);
+   int ierr;
+   if(opkind == TALSH_TENSOR_CONTRACT){
+    ierr=talsh::cpu::tensor_image_contract(contr_ptrn,ltens[op],imgs[1],rtens[op],imgs[2],dtens[op],0,
+                                           scale_real,scale_imag,conj_bits,accumulative);
+   }else{
+    ierr=talsh::cpu::tensor_image_add(contr_ptrn,ltens[op],imgs[1],dtens[op],0,scale_real,scale_imag,conj_bits,accumulative);
+   }
+   if(ierr != 0){
+#pragma omp atomic write
+    errc=TALSH_FAILURE;
+   }
+  }
+ }
+ if(errc != TALSH_SUCCESS) return errc;
+ //Execute the remaining tensor operations one by one:
+ if(dependent){
+  others.resize(num_ops); for(i=0;i<num_ops;++i) others[i]=i;
+ }else{
+  std::sort(others.begin(),others.end());
+ }
+ for(const int op: others){
+  if(opkind == TALSH_TENSOR_CONTRACT){
+   errc=talshTensorContract(cptrn,dtens[op],ltens[op],rtens[op],scale_real,scale_imag,DEV_DEFAULT,DEV_DEFAULT,COPY_MTT,accumulative);
+  }else{
+   errc=talshTensorAdd(cptrn,dtens[op],ltens[op],scale_real,scale_imag);
+  }
+  if(errc != TALSH_SUCCESS) break;
+ }
+#pragma omp flush
+ return errc;
+}
+
+int talshTensorAddBatch(const char * cptrn,    //in: C-string: symbolic addition pattern, e.g. "D(a,b,c,d)+=L(c,d,b,a)"
+                        int num_ops,           //in: number of tensor additions in the batch
+                        talsh_tens_t * dtens[], //inout: destination tensor blocks
+                        talsh_tens_t * ltens[], //inout: source tensor blocks
+                        double scale_real,     //in: scaling value (real part), defaults to 1
+                        double scale_imag)     //in: scaling value (imaginary part), defaults to 0
+/** Batched tensor addition (blocking): dtens[i] += ltens[i] * scale, i=[0..num_ops-1] **/
+{
+ return talsh_tensor_batch(TALSH_TENSOR_ADD,cptrn,num_ops,dtens,ltens,NULL,scale_real,scale_imag,YEP);
+}
+
+int talshTensorContractBatch(const char * cptrn,    //in: C-string: symbolic contraction pattern, e.g. "D(a,b,c,d)+=L(c,i,j,a)*R(b,j,d,i)"
+                             int num_ops,           //in: number of tensor contractions in the batch
+                             talsh_tens_t * dtens[], //inout: destination tensor blocks
+                             talsh_tens_t * ltens[], //inout: left source tensor blocks
+                             talsh_tens_t * rtens[], //inout: right source tensor blocks
+                             double scale_real,     //in: scaling value (real part), defaults to 1
+                             double scale_imag,     //in: scaling value (imaginary part), defaults to 0
+                             int accumulative)      //in: accumulate in (default) VS overwrite destination tensors: [YEP|NOPE]
+/** Batched tensor contraction (blocking): dtens[i] += ltens[i] * rtens[i] * scale, i=[0..num_ops-1] **/
+{
+ return talsh_tensor_batch(TALSH_TENSOR_CONTRACT,cptrn,num_ops,dtens,ltens,rtens,scale_real,scale_imag,accumulative);
+}
+
 int talshTensorDecomposeSVD(const char * cptrn,   //in: C-string: symbolic decomposition pattern, e.g. "D(a,b,c,d)=L(c,i,j,a)*R(b,j,d,i)"
                             talsh_tens_t * dtens, //in: tensor block to be decomposed
                             talsh_tens_t * ltens, //inout: left tensor factor
@@ -111,6 +111,24 @@ double imagPart(std::complex<double> number);
 
 //Classes:
 
+class Tensor;
+
+//Batched tensor operations sharing the same pattern (blocking, small tensors are processed in one parallel sweep on Host):
+// dest[i] += left[i] * scalar_factor
+template <typename T = double>
+int accumulateBatch(const std::string & pattern,            //in: accumulation pattern string
+                    const std::vector<Tensor*> & dest,      //inout: destination tensors
+                    const std::vector<Tensor*> & left,      //in: left tensors
+                    const T factor = TensorData<T>::unity); //in: scalar factor
+// dest[i] += left[i] * right[i] * scalar_factor
+template <typename T = double>
+int contractAccumulateBatch(const std::string & pattern,           //in: contraction pattern string
+                            const std::vector<Tensor*> & dest,     //inout: destination tensors
+                            const std::vector<Tensor*> & left,     //in: left tensors
+                            const std::vector<Tensor*> & right,    //in: right tensors
+                            const T factor = TensorData<T>::unity, //in: scalar factor (alpha)
+                            bool accumulative = true);             //in: accumulate versus overwrite the destination tensors
+
 /** Dense local tensor **/
 class Tensor{
 
@@ -457,6 +475,13 @@ public:
  friend int determineOptimalDevice(Tensor & tens0);
  friend int determineOptimalDevice(Tensor & tens0, Tensor & tens1);
  friend int determineOptimalDevice(Tensor & tens0, Tensor & tens1, Tensor & tens2);
+ template <typename T>
+ friend int accumulateBatch(const std::string & pattern, const std::vector<Tensor*> & dest,
+                            const std::vector<Tensor*> & left, const T factor);
+ template <typename T>
+ friend int contractAccumulateBatch(const std::string & pattern, const std::vector<Tensor*> & dest,
+                                    const std::vector<Tensor*> & left, const std::vector<Tensor*> & right,
+                                    const T factor, bool accumulative);
 
 private:
 
@@ -988,6 +1013,59 @@ int Tensor::multiplyAccumulate(TensorTask * task_handle, //out: task handle asso
 }
 
 
+template <typename T>
+int accumulateBatch(const std::string & pattern,       //in: accumulation pattern string
+                    const std::vector<Tensor*> & dest, //inout: destination tensors
+                    const std::vector<Tensor*> & left, //in: left tensors
+                    const T factor)                    //in: scalar factor
+{
+ const std::size_t num_ops = dest.size();
+ if(left.size() != num_ops) return TALSH_INVALID_ARGS;
+ std::vector<talsh_tens_t*> dtens(num_ops), ltens(num_ops);
+ for(std::size_t i = 0; i < num_ops; ++i){
+  dest[i]->completeWriteTask();
+  left[i]->completeWriteTask();
+  dtens[i] = dest[i]->getTalshTensorPtr();
+  ltens[i] = left[i]->getTalshTensorPtr();
+ }
+ int errc = talshTensorAddBatch(pattern.c_str(),static_cast<int>(num_ops),dtens.data(),ltens.data(),
+                                realPart(factor),imagPart(factor));
+ if(errc != TALSH_SUCCESS)
+  std::cout << "#ERROR(talsh::accumulateBatch): talshTensorAddBatch error " << errc << std::endl; //debug
+ assert(errc == TALSH_SUCCESS);
+ return errc;
+}
+
+
+template <typename T>
+int contractAccumulateBatch(const std::string & pattern,        //in: contraction pattern string
+                            const std::vector<Tensor*> & dest,  //inout: destination tensors
+                            const std::vector<Tensor*> & left,  //in: left tensors
+                            const std::vector<Tensor*> & right, //in: right tensors
+                            const T factor,                     //in: scalar factor (alpha)
+                            bool accumulative)                  //in: accumulate in (default) VS overwrite destination tensors
+{
+ const std::size_t num_ops = dest.size();
+ if(left.size() != num_ops || right.size() != num_ops) return TALSH_INVALID_ARGS;
+ std::vector<talsh_tens_t*> dtens(num_ops), ltens(num_ops), rtens(num_ops);
+ for(std::size_t i = 0; i < num_ops; ++i){
+  dest[i]->completeWriteTask();
+  left[i]->completeWriteTask();
+  right[i]->completeWriteTask();
+  dtens[i] = dest[i]->getTalshTensorPtr();
+  ltens[i] = left[i]->getTalshTensorPtr();
+  rtens[i] = right[i]->getTalshTensorPtr();
+ }
+ int accum = YEP; if(!accumulative) accum = NOPE;
+ int errc = talshTensorContractBatch(pattern.c_str(),static_cast<int>(num_ops),dtens.data(),ltens.data(),rtens.data(),
+                                     realPart(factor),imagPart(factor),accum);
+ if(errc != TALSH_SUCCESS)
+  std::cout << "#ERROR(talsh::contractAccumulateBatch): talshTensorContractBatch error " << errc << std::endl; //debug
+ assert(errc == TALSH_SUCCESS);
+ return errc;
+}
+
+
 } //namespace talsh
 
 #endif //TALSHXX_HPP_
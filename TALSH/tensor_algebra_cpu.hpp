@@ -0,0 +1,727 @@
+/** ExaTensor::TAL-SH: Native C++ CP-TAL (multicore CPU Host) tensor algebra backend.
+REVISION: 2020/07/21
+
+Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
+Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
+
+This file is part of ExaTensor.
+
+ExaTensor is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ExaTensor is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+
+FOR DEVELOPER(s):
+ # Header-only implementation of the basic Host tensor operations acting
+   directly on TAL-SH tensor body images (init, scale, copy/permute, add,
+   slice, insert, contract), templated on the data type {float, double,
+   std::complex<float>, std::complex<double>}. Contrary to the Fortran CP-TAL,
+   no <tensor_block_t> aliases are created, thus the fixed cost of a tensor
+   operation is reduced to a few microseconds, which pays off for small tensors.
+   Larger tensor operations are still better served by the Fortran CP-TAL
+   (BLAS, autotuned tensor transposes), see the TAL-SH dispatcher (talshc.cpp).
+ # The dense tensor storage layout is column-wise (the first dimension is minor).
+ # The semantics of the digital index patterns and complex conjugation bits
+   matches that of the Fortran CP-TAL (cpu_tensor_block_XXX() in talshf.F90).
+ # All tensor operations are blocking and return 0 on success, a positive error code otherwise.
+   The matricization of a tensor contraction is cached per thread, thus consecutive tensor
+   contractions of the same shape (batched tensor operations) skip it.
+   Asynchronous execution of Host tasks is provided by the TaskPool, which runs
+   submitted tasks on a fixed set of worker threads, each one owning an equal
+   share of the OpenMP threads (the TAL-SH runtime owns the pool, see talshc.cpp).
+**/
+
+#ifndef TENSOR_ALGEBRA_CPU_HPP_
+#define TENSOR_ALGEBRA_CPU_HPP_
+
+#include <cstddef>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <omp.h>
+
+#include "talsh.h"
+
+namespace talsh{
+
+namespace cpu{
+
+//Min amount of work (elements or multiply-adds) per OpenMP thread:
+constexpr std::size_t PARALLEL_WORK_MIN = 32768;
+
+/** Returns the real approximant of a complex number preserving its modulus and
+    sign inversion symmetry (same as cmplx8_to_real8() in the Fortran CP-TAL). **/
+inline double real_approximant(double real, double imag)
+{
+ if(real != 0.0) return std::abs(std::complex<double>(real,imag))*((real > 0.0) ? 1.0 : -1.0);
+ return imag;
+}
+
+/** Scalar type traits (real/complex): A complex scalar is converted to a real one either
+    by taking its real part (make) or its real approximant (approximate), following the
+    conventions of the Fortran CP-TAL for tensor contractions and other tensor operations. **/
+template <typename T>
+struct ScalarTraits{
+ static T make(double real, double imag){return static_cast<T>(real);}
+ static T approximate(double real, double imag){return static_cast<T>(real_approximant(real,imag));}
+ static T conjg(const T & val){return val;}
+};
+
+template <typename T>
+struct ScalarTraits<std::complex<T>>{
+ static std::complex<T> make(double real, double imag){return std::complex<T>(static_cast<T>(real),static_cast<T>(imag));}
+ static std::complex<T> approximate(double real, double imag){return make(real,imag);}
+ static std::complex<T> conjg(const std::complex<T> & val){return std::conj(val);}
+};
+
+/** Dense tensor body image (non-owning view). **/
+template <typename T>
+struct TensorImage{
+ int rank;         //tensor rank (number of dimensions)
+ const int * dims; //tensor dimension extents
+ T * body;         //tensor body (column-wise storage)
+
+ std::size_t volume() const{
+  std::size_t vol = 1; for(int i = 0; i < rank; ++i) vol*=static_cast<std::size_t>(dims[i]);
+  return vol;
+ }
+
+ /** Sets the natural strides of all dimensions. **/
+ void getStrides(std::size_t * strides) const{
+  std::size_t str = 1;
+  for(int i = 0; i < rank; ++i){strides[i] = str; str*=static_cast<std::size_t>(dims[i]);}
+ }
+};
+
+/** Returns the number of OpenMP threads for a given amount of work. **/
+inline int num_threads_for(std::size_t work)
+{
+ if(work < 2*PARALLEL_WORK_MIN) return 1;
+ std::size_t nthreads = work/PARALLEL_WORK_MIN;
+ std::size_t max_threads = static_cast<std::size_t>(omp_get_max_threads());
+ if(nthreads > max_threads) nthreads = max_threads;
+ return static_cast<int>(nthreads);
+}
+
+/** Fills in the element offsets of all multi-indices of an index box
+    (the first index is minor) given the strides of its dimensions. **/
+inline void box_offsets(int n, const std::size_t * ext, const std::size_t * str, std::vector<std::size_t> & offsets)
+{
+ offsets.assign(1,0);
+ for(int i = 0; i < n; ++i){
+  const std::size_t len = offsets.size();
+  offsets.resize(len*ext[i]);
+  for(std::size_t k = 1; k < ext[i]; ++k){
+   const std::size_t shift = k*str[i]; std::size_t * offs = &(offsets[k*len]);
+   for(std::size_t l = 0; l < len; ++l) offs[l] = offsets[l] + shift;
+  }
+ }
+ return;
+}
+
+/** Dot product of two vectors (complex vectors are processed as interleaved real ones). **/
+template <typename T>
+inline T dot_product(std::size_t n, const T * x, const T * y)
+{
+ T sum = static_cast<T>(0);
+#pragma omp simd reduction(+:sum)
+ for(std::size_t k = 0; k < n; ++k) sum+=x[k]*y[k];
+ return sum;
+}
+
+template <typename T>
+inline std::complex<T> dot_product(std::size_t n, const std::complex<T> * x, const std::complex<T> * y)
+{
+ const T * xr = reinterpret_cast<const T*>(x);
+ const T * yr = reinterpret_cast<const T*>(y);
+ T sum_re = static_cast<T>(0), sum_im = static_cast<T>(0);
+#pragma omp simd reduction(+:sum_re,sum_im)
+ for(std::size_t k = 0; k < n; ++k){
+  sum_re+=xr[2*k]*yr[2*k] - xr[2*k+1]*yr[2*k+1];
+  sum_im+=xr[2*k]*yr[2*k+1] + xr[2*k+1]*yr[2*k];
+ }
+ return std::complex<T>(sum_re,sum_im);
+}
+
+/** Four dot products of two pairs of vectors at once (register blocking): sum[2*j+i] = x_i * y_j. **/
+template <typename T>
+inline void dot_product_2x2(std::size_t n, const T * x0, const T * x1, const T * y0, const T * y1, T * sum)
+{
+ T s00 = static_cast<T>(0), s10 = static_cast<T>(0), s01 = static_cast<T>(0), s11 = static_cast<T>(0);
+#pragma omp simd reduction(+:s00,s10,s01,s11)
+ for(std::size_t k = 0; k < n; ++k){
+  s00+=x0[k]*y0[k]; s10+=x1[k]*y0[k]; s01+=x0[k]*y1[k]; s11+=x1[k]*y1[k];
+ }
+ sum[0] = s00; sum[1] = s10; sum[2] = s01; sum[3] = s11;
+ return;
+}
+
+template <typename T>
+inline void dot_product_2x2(std::size_t n, const std::complex<T> * x0, const std::complex<T> * x1,
+                            const std::complex<T> * y0, const std::complex<T> * y1, std::complex<T> * sum)
+{
+ sum[0] = dot_product(n,x0,y0); sum[1] = dot_product(n,x1,y0);
+ sum[2] = dot_product(n,x0,y1); sum[3] = dot_product(n,x1,y1);
+ return;
+}
+
+/** Elementwise update over a rank-<n> index box: dst[] = alpha * op(src[]) (+ dst[] if accumulative),
+    where op() is an optional complex conjugation and the element offsets are defined by the
+    strides of each argument. The innermost loop runs over the dimension minor in <dst>. **/
+template <typename T, bool CONJ, bool ACCUM>
+void update_box(int n, const std::size_t * ext, const T * src, const std::size_t * src_str,
+                T * dst, const std::size_t * dst_str, const T alpha)
+{
+ std::size_t vol = 1; for(int i = 0; i < n; ++i) vol*=ext[i];
+ if(vol == 0) return;
+ int minor = 0; for(int i = 1; i < n; ++i) if(dst_str[i] < dst_str[minor]) minor = i;
+ //Collapse the index box into the inner (minor) dimension and the outer ones:
+ const std::size_t len = (n > 0) ? ext[minor] : 1;
+ const std::size_t ssd = (n > 0) ? src_str[minor] : 0;
+ const std::size_t dsd = (n > 0) ? dst_str[minor] : 0;
+ std::size_t oext[MAX_TENSOR_RANK], osst[MAX_TENSOR_RANK], odst[MAX_TENSOR_RANK];
+ int on = 0;
+ for(int i = 0; i < n; ++i){
+  if(i != minor){oext[on] = ext[i]; osst[on] = src_str[i]; odst[on] = dst_str[i]; ++on;}
+ }
+ const std::size_t nrows = vol/len;
+ const int nthreads = num_threads_for(vol);
+#pragma omp parallel num_threads(nthreads) if(nthreads > 1)
+ {
+  const std::size_t nthr = static_cast<std::size_t>(omp_get_num_threads());
+  const std::size_t tid = static_cast<std::size_t>(omp_get_thread_num());
+  const std::size_t row_beg = (nrows*tid)/nthr, row_end = (nrows*(tid+1))/nthr;
+  if(row_beg < row_end){
+   //Decode the first outer multi-index:
+   std::size_t mlndx[MAX_TENSOR_RANK], soff = 0, doff = 0, row = row_beg;
+   for(int i = 0; i < on; ++i){
+    mlndx[i] = row % oext[i]; row/=oext[i];
+    soff+=mlndx[i]*osst[i]; doff+=mlndx[i]*odst[i];
+   }
+   for(row = row_beg; row < row_end; ++row){
+    const T * sp = src + soff; T * dp = dst + doff;
+    for(std::size_t k = 0; k < len; ++k){
+     T val = sp[k*ssd]; if(CONJ) val = ScalarTraits<T>::conjg(val);
+     if(ACCUM){dp[k*dsd]+=alpha*val;}else{dp[k*dsd]=alpha*val;}
+    }
+    //Increment the outer multi-index:
+    for(int i = 0; i < on; ++i){
+     soff+=osst[i]; doff+=odst[i];
+     if(++mlndx[i] < oext[i]) break;
+     soff-=oext[i]*osst[i]; doff-=oext[i]*odst[i]; mlndx[i] = 0;
+    }
+   }
+  }
+ }
+ return;
+}
+
+template <typename T>
+void update_box(int n, const std::size_t * ext, const T * src, const std::size_t * src_str,
+                T * dst, const std::size_t * dst_str, const T alpha, bool conj, bool accumulative)
+{
+ if(conj){
+  if(accumulative){
+   update_box<T,true,true>(n,ext,src,src_str,dst,dst_str,alpha);
+  }else{
+   update_box<T,true,false>(n,ext,src,src_str,dst,dst_str,alpha);
+  }
+ }else{
+  if(accumulative){
+   update_box<T,false,true>(n,ext,src,src_str,dst,dst_str,alpha);
+  }else{
+   update_box<T,false,false>(n,ext,src,src_str,dst,dst_str,alpha);
+  }
+ }
+ return;
+}
+
+/** Splits complex conjugation bits into the flags of the left and right arguments
+    (conjugation of the destination is conjugation of all input arguments). **/
+inline void conj_flags(int conj_bits, bool * lconj, bool * rconj)
+{
+ const bool dconj = ((conj_bits & 1) != 0);
+ *lconj = ((conj_bits & 2) != 0); *rconj = ((conj_bits & 4) != 0);
+ if(dconj){*lconj = !(*lconj); *rconj = !(*rconj);}
+ return;
+}
+
+/** Tensor initialization: dtens[] = val. **/
+template <typename T>
+int init(TensorImage<T> & dtens, const T val)
+{
+ const std::size_t vol = dtens.volume();
+ T * body = dtens.body;
+ const int nthreads = num_threads_for(vol);
+#pragma omp parallel for num_threads(nthreads) schedule(static) if(nthreads > 1)
+ for(std::size_t l = 0; l < vol; ++l) body[l] = val;
+ return 0;
+}
+
+/** Tensor scaling: dtens[] *= alpha. **/
+template <typename T>
+int scale(TensorImage<T> & dtens, const T alpha)
+{
+ const std::size_t vol = dtens.volume();
+ T * body = dtens.body;
+ const int nthreads = num_threads_for(vol);
+#pragma omp parallel for num_threads(nthreads) schedule(static) if(nthreads > 1)
+ for(std::size_t l = 0; l < vol; ++l) body[l]*=alpha;
+ return 0;
+}
+
+/** Tensor permutation: dtens[permuted] = alpha * op(ltens[]) (+ dtens[] if accumulative).
+    <o2n>[0..rank-1] is the O2N index permutation: position (1..rank) of each <ltens> dimension in <dtens>.
+    Error codes: 1: rank mismatch, 2: invalid permutation, 3: extent mismatch. **/
+template <typename T>
+int permute(const int * o2n, const TensorImage<T> & ltens, TensorImage<T> & dtens,
+            const T alpha, bool conj, bool accumulative)
+{
+ std::size_t ext[MAX_TENSOR_RANK], lstr[MAX_TENSOR_RANK], dnat[MAX_TENSOR_RANK], dstr[MAX_TENSOR_RANK];
+ const int n = ltens.rank;
+ if(dtens.rank != n) return 1;
+ unsigned int used = 0;
+ for(int i = 0; i < n; ++i){
+  const int j = o2n[i] - 1;
+  if(j < 0 || j >= n || (used & (1U << j)) != 0) return 2;
+  if(dtens.dims[j] != ltens.dims[i]) return 3;
+  used|=(1U << j);
+ }
+ ltens.getStrides(lstr); dtens.getStrides(dnat);
+ for(int i = 0; i < n; ++i){ext[i] = static_cast<std::size_t>(ltens.dims[i]); dstr[i] = dnat[o2n[i]-1];}
+ update_box(n,ext,ltens.body,lstr,dtens.body,dstr,alpha,conj,accumulative);
+ return 0;
+}
+
+/** Tensor slicing: dtens[] = ltens[offsets + ...] (+ dtens[] if accumulative).
+    Error codes: 1: rank mismatch, 2: slice out of bounds. **/
+template <typename T>
+int slice(const TensorImage<T> & ltens, TensorImage<T> & dtens, const int * offsets, bool accumulative)
+{
+ std::size_t ext[MAX_TENSOR_RANK], lstr[MAX_TENSOR_RANK], dstr[MAX_TENSOR_RANK];
+ const int n = dtens.rank;
+ if(ltens.rank != n) return 1;
+ ltens.getStrides(lstr); dtens.getStrides(dstr);
+ std::size_t base = 0;
+ for(int i = 0; i < n; ++i){
+  if(offsets[i] < 0 || offsets[i] + dtens.dims[i] > ltens.dims[i]) return 2;
+  ext[i] = static_cast<std::size_t>(dtens.dims[i]); base+=static_cast<std::size_t>(offsets[i])*lstr[i];
+ }
+ update_box(n,ext,ltens.body+base,lstr,dtens.body,dstr,static_cast<T>(1),false,accumulative);
+ return 0;
+}
+
+/** Tensor slice insertion: dtens[offsets + ...] = ltens[] (+ dtens[offsets + ...] if accumulative).
+    Error codes: 1: rank mismatch, 2: slice out of bounds. **/
+template <typename T>
+int insert(const TensorImage<T> & ltens, TensorImage<T> & dtens, const int * offsets, bool accumulative)
+{
+ std::size_t ext[MAX_TENSOR_RANK], lstr[MAX_TENSOR_RANK], dstr[MAX_TENSOR_RANK];
+ const int n = dtens.rank;
+ if(ltens.rank != n) return 1;
+ ltens.getStrides(lstr); dtens.getStrides(dstr);
+ std::size_t base = 0;
+ for(int i = 0; i < n; ++i){
+  if(offsets[i] < 0 || offsets[i] + ltens.dims[i] > dtens.dims[i]) return 2;
+  ext[i] = static_cast<std::size_t>(ltens.dims[i]); base+=static_cast<std::size_t>(offsets[i])*dstr[i];
+ }
+ update_box(n,ext,ltens.body,lstr,dtens.body+base,dstr,static_cast<T>(1),false,accumulative);
+ return 0;
+}
+
+/** Packs a tensor argument of a tensor contraction as a matrix with the contracted
+    multi-index minor: mat[u*nc + c] = op(body[uoffs[u] + coffs[c]]). Returns a pointer to
+    the tensor body itself when it already has that layout and no conjugation is needed. **/
+template <typename T>
+const T * pack_matrix(const T * body, const std::vector<std::size_t> & uoffs, const std::vector<std::size_t> & coffs,
+                      bool conj, std::vector<T> & mat)
+{
+ const std::size_t nu = uoffs.size(), nc = coffs.size();
+ if(!conj){
+  bool direct = true;
+  for(std::size_t c = 0; c < nc; ++c){if(coffs[c] != c){direct = false; break;}}
+  if(direct){for(std::size_t u = 0; u < nu; ++u){if(uoffs[u] != u*nc){direct = false; break;}}}
+  if(direct) return body;
+ }
+ mat.resize(nu*nc);
+ T * mp = mat.data();
+ const int nthreads = num_threads_for(nu*nc);
+#pragma omp parallel for num_threads(nthreads) schedule(static) if(nthreads > 1)
+ for(std::size_t u = 0; u < nu; ++u){
+  const T * bp = body + uoffs[u];
+  if(conj){
+   for(std::size_t c = 0; c < nc; ++c) mp[u*nc + c] = ScalarTraits<T>::conjg(bp[coffs[c]]);
+  }else{
+   for(std::size_t c = 0; c < nc; ++c) mp[u*nc + c] = bp[coffs[c]];
+  }
+ }
+ return mp;
+}
+
+/** Tensor contraction: dtens[] = alpha * op(ltens[]) * op(rtens[]) (+ dtens[] if accumulative).
+    The digital contraction pattern <contr_ptrn>[0..lrank+rrank-1] refers to the dimensions of the
+    left and then right tensor argument: A positive value is the position (1..drank) of an uncontracted
+    dimension in <dtens>, a negative value is minus the position of a contracted dimension in the other argument.
+    Error codes: 1: invalid contraction pattern, 2: extent mismatch, 3: incomplete destination. **/
+template <typename T>
+int contract(const int * contr_ptrn, const TensorImage<T> & ltens, const TensorImage<T> & rtens, TensorImage<T> & dtens,
+             const T alpha, bool lconj, bool rconj, bool accumulative)
+{
+ std::size_t lstr[MAX_TENSOR_RANK], rstr[MAX_TENSOR_RANK], dstr[MAX_TENSOR_RANK];
+ std::size_t lu_ext[MAX_TENSOR_RANK], lu_lstr[MAX_TENSOR_RANK], lu_dstr[MAX_TENSOR_RANK];
+ std::size_t ru_ext[MAX_TENSOR_RANK], ru_rstr[MAX_TENSOR_RANK], ru_dstr[MAX_TENSOR_RANK];
+ std::size_t c_ext[MAX_TENSOR_RANK], c_lstr[MAX_TENSOR_RANK], c_rstr[MAX_TENSOR_RANK];
+ const int lrank = ltens.rank, rrank = rtens.rank, drank = dtens.rank;
+ ltens.getStrides(lstr); rtens.getStrides(rstr); dtens.getStrides(dstr);
+ //Classify the tensor dimensions:
+ unsigned int dused = 0;
+ int nlu = 0, nru = 0, ncd = 0;
+ for(int i = 0; i < lrank; ++i){
+  const int j = contr_ptrn[i];
+  if(j > 0){ //uncontracted left dimension
+   if(j > drank || (dused & (1U << (j-1))) != 0) return 1;
+   if(dtens.dims[j-1] != ltens.dims[i]) return 2;
+   dused|=(1U << (j-1));
+   lu_ext[nlu] = static_cast<std::size_t>(ltens.dims[i]); lu_lstr[nlu] = lstr[i]; lu_dstr[nlu] = dstr[j-1]; ++nlu;
+  }else if(j < 0){ //contracted dimension
+   if(-j > rrank || contr_ptrn[lrank-j-1] != -(i+1)) return 1;
+   if(rtens.dims[-j-1] != ltens.dims[i]) return 2;
+   c_ext[ncd] = static_cast<std::size_t>(ltens.dims[i]); c_lstr[ncd] = lstr[i]; c_rstr[ncd] = rstr[-j-1]; ++ncd;
+  }else{
+   return 1;
+  }
+ }
+ for(int i = 0; i < rrank; ++i){
+  const int j = contr_ptrn[lrank+i];
+  if(j > 0){ //uncontracted right dimension
+   if(j > drank || (dused & (1U << (j-1))) != 0) return 1;
+   if(dtens.dims[j-1] != rtens.dims[i]) return 2;
+   dused|=(1U << (j-1));
+   ru_ext[nru] = static_cast<std::size_t>(rtens.dims[i]); ru_rstr[nru] = rstr[i]; ru_dstr[nru] = dstr[j-1]; ++nru;
+  }else if(j < 0){ //contracted dimension (already registered)
+   if(-j > lrank || contr_ptrn[-j-1] != -(i+1)) return 1;
+  }else{
+   return 1;
+  }
+ }
+ if(nlu + nru != drank) return 3;
+ //Matricize the tensor arguments (the index offsets are reused by consecutive contractions of the same shape):
+ int shape[3 + MAX_TENSOR_RANK*5], nsh = 0;
+ shape[nsh++] = lrank; shape[nsh++] = rrank; shape[nsh++] = drank;
+ for(int i = 0; i < lrank; ++i) shape[nsh++] = ltens.dims[i];
+ for(int i = 0; i < rrank; ++i) shape[nsh++] = rtens.dims[i];
+ for(int i = 0; i < drank; ++i) shape[nsh++] = dtens.dims[i];
+ for(int i = 0; i < lrank + rrank; ++i) shape[nsh++] = contr_ptrn[i];
+ static thread_local std::vector<int> last_shape;
+ static thread_local std::vector<std::size_t> lu_loffs, lu_doffs, ru_roffs, ru_doffs, c_loffs, c_roffs;
+ if(last_shape.size() != static_cast<std::size_t>(nsh) || !std::equal(last_shape.begin(),last_shape.end(),shape)){
+  box_offsets(nlu,lu_ext,lu_lstr,lu_loffs); box_offsets(nlu,lu_ext,lu_dstr,lu_doffs);
+  box_offsets(nru,ru_ext,ru_rstr,ru_roffs); box_offsets(nru,ru_ext,ru_dstr,ru_doffs);
+  box_offsets(ncd,c_ext,c_lstr,c_loffs); box_offsets(ncd,c_ext,c_rstr,c_roffs);
+  last_shape.assign(shape,shape+nsh);
+ }
+ const std::size_t ni = lu_loffs.size(), nj = ru_roffs.size(), nc = c_loffs.size();
+ if(ni == 0 || nj == 0) return 0;
+ T * dbody = dtens.body;
+ if(nc == 0){ //contraction over an empty range
+  if(!accumulative){
+   for(std::size_t j = 0; j < nj; ++j){for(std::size_t i = 0; i < ni; ++i) dbody[lu_doffs[i] + ru_doffs[j]] = static_cast<T>(0);}
+  }
+  return 0;
+ }
+ static thread_local std::vector<T> lmat, rmat;
+ const T * lm = pack_matrix(ltens.body,lu_loffs,c_loffs,lconj,lmat);
+ const T * rm = pack_matrix(rtens.body,ru_roffs,c_roffs,rconj,rmat);
+ //Multiply matrices in 2x2 blocks and scatter the result into the destination tensor:
+ const std::size_t * di = lu_doffs.data();
+ const std::size_t * dj = ru_doffs.data();
+ const std::size_t nbi = (ni + 1)/2, nbj = (nj + 1)/2;
+ const int nthreads = num_threads_for(ni*nj*nc);
+#pragma omp parallel for num_threads(nthreads) collapse(2) schedule(static) if(nthreads > 1)
+ for(std::size_t jb = 0; jb < nbj; ++jb){
+  for(std::size_t ib = 0; ib < nbi; ++ib){
+   const std::size_t i0 = ib*2, j0 = jb*2;
+   const std::size_t i1 = (i0 + 1 < ni) ? (i0 + 1) : i0, j1 = (j0 + 1 < nj) ? (j0 + 1) : j0;
+   T sum[4];
+   dot_product_2x2(nc,&(lm[i0*nc]),&(lm[i1*nc]),&(rm[j0*nc]),&(rm[j1*nc]),sum);
+   const std::size_t doffs[4] = {di[i0]+dj[j0],di[i1]+dj[j0],di[i0]+dj[j1],di[i1]+dj[j1]};
+   for(int k = 0; k < 4; ++k){
+    if((k & 1) != 0 && i1 == i0) continue; //duplicate row
+    if((k & 2) != 0 && j1 == j0) continue; //duplicate column
+    if(accumulative){dbody[doffs[k]]+=alpha*sum[k];}else{dbody[doffs[k]]=alpha*sum[k];}
+   }
+  }
+ }
+ return 0;
+}
+
+
+//TAL-SH TENSOR IMAGE INTERFACE:
+
+/** Returns TRUE if the data kind is supported by the native backend. **/
+inline bool valid_data_kind(int data_kind)
+{
+ return (data_kind == R4 || data_kind == R8 || data_kind == C4 || data_kind == C8);
+}
+
+/** Returns a view of a given body image of a TAL-SH tensor. **/
+template <typename T>
+inline TensorImage<T> tensor_image(const talsh_tens_t * tens, int image_id)
+{
+ return TensorImage<T>{tens->shape_p->num_dim,tens->shape_p->dims,static_cast<T*>(tens->dev_rsc[image_id].gmem_p)};
+}
+
+template <typename T>
+int init_image(talsh_tens_t * dtens, int dimg, double val_real, double val_imag)
+{
+ auto dt = tensor_image<T>(dtens,dimg);
+ return init(dt,ScalarTraits<T>::approximate(val_real,val_imag));
+}
+
+template <typename T>
+int scale_image(talsh_tens_t * dtens, int dimg, double scale_real, double scale_imag)
+{
+ auto dt = tensor_image<T>(dtens,dimg);
+ return scale(dt,ScalarTraits<T>::approximate(scale_real,scale_imag));
+}
+
+template <typename T>
+int slice_image(const talsh_tens_t * ltens, int limg, talsh_tens_t * dtens, int dimg, const int * offsets, bool accumulative)
+{
+ auto dt = tensor_image<T>(dtens,dimg);
+ return slice(tensor_image<T>(ltens,limg),dt,offsets,accumulative);
+}
+
+template <typename T>
+int insert_image(const talsh_tens_t * ltens, int limg, talsh_tens_t * dtens, int dimg, const int * offsets, bool accumulative)
+{
+ auto dt = tensor_image<T>(dtens,dimg);
+ return insert(tensor_image<T>(ltens,limg),dt,offsets,accumulative);
+}
+
+template <typename T>
+int add_image(const int * contr_ptrn, const talsh_tens_t * ltens, int limg, talsh_tens_t * dtens, int dimg,
+              double scale_real, double scale_imag, bool lconj, bool accumulative)
+{
+ auto dt = tensor_image<T>(dtens,dimg);
+ return permute(contr_ptrn,tensor_image<T>(ltens,limg),dt,ScalarTraits<T>::approximate(scale_real,scale_imag),
+                lconj,accumulative);
+}
+
+template <typename T>
+int contract_image(const int * contr_ptrn, const talsh_tens_t * ltens, int limg, const talsh_tens_t * rtens, int rimg,
+                   talsh_tens_t * dtens, int dimg, double scale_real, double scale_imag, bool lconj, bool rconj, bool accumulative)
+{
+ auto dt = tensor_image<T>(dtens,dimg);
+ auto lt = tensor_image<T>(ltens,limg);
+ auto rt = tensor_image<T>(rtens,rimg);
+ //Tensor-by-scalar multiplication is a tensor addition (the scaling factor follows its convention):
+ const bool addition = (dt.rank > 0 && (lt.rank == 0 || rt.rank == 0));
+ const T alpha = addition ? ScalarTraits<T>::approximate(scale_real,scale_imag) : ScalarTraits<T>::make(scale_real,scale_imag);
+ return contract(contr_ptrn,lt,rt,dt,alpha,lconj,rconj,accumulative);
+}
+
+/** Initializes a tensor body image (conjugation bits: 0:D). **/
+inline int tensor_image_init(talsh_tens_t * dtens, int dimg, double val_real, double val_imag, int arg_conj)
+{
+ if((arg_conj & 1) != 0) val_imag=-val_imag;
+ switch(dtens->data_kind[dimg]){
+ case R4: return init_image<float>(dtens,dimg,val_real,val_imag);
+ case R8: return init_image<double>(dtens,dimg,val_real,val_imag);
+ case C4: return init_image<std::complex<float>>(dtens,dimg,val_real,val_imag);
+ case C8: return init_image<std::complex<double>>(dtens,dimg,val_real,val_imag);
+ }
+ return 100;
+}
+
+/** Scales a tensor body image. **/
+inline int tensor_image_scale(talsh_tens_t * dtens, int dimg, double scale_real, double scale_imag)
+{
+ switch(dtens->data_kind[dimg]){
+ case R4: return scale_image<float>(dtens,dimg,scale_real,scale_imag);
+ case R8: return scale_image<double>(dtens,dimg,scale_real,scale_imag);
+ case C4: return scale_image<std::complex<float>>(dtens,dimg,scale_real,scale_imag);
+ case C8: return scale_image<std::complex<double>>(dtens,dimg,scale_real,scale_imag);
+ }
+ return 100;
+}
+
+/** Extracts a slice from a tensor body image (<ltens> -> <dtens>). **/
+inline int tensor_image_slice(const talsh_tens_t * ltens, int limg, talsh_tens_t * dtens, int dimg,
+                              const int * offsets, int accumulative)
+{
+ const bool accum = (accumulative == YEP);
+ if(ltens->data_kind[limg] != dtens->data_kind[dimg]) return 101;
+ switch(dtens->data_kind[dimg]){
+ case R4: return slice_image<float>(ltens,limg,dtens,dimg,offsets,accum);
+ case R8: return slice_image<double>(ltens,limg,dtens,dimg,offsets,accum);
+ case C4: return slice_image<std::complex<float>>(ltens,limg,dtens,dimg,offsets,accum);
+ case C8: return slice_image<std::complex<double>>(ltens,limg,dtens,dimg,offsets,accum);
+ }
+ return 100;
+}
+
+/** Inserts a slice into a tensor body image (<ltens> -> <dtens>). **/
+inline int tensor_image_insert(const talsh_tens_t * ltens, int limg, talsh_tens_t * dtens, int dimg,
+                               const int * offsets, int accumulative)
+{
+ const bool accum = (accumulative == YEP);
+ if(ltens->data_kind[limg] != dtens->data_kind[dimg]) return 101;
+ switch(dtens->data_kind[dimg]){
+ case R4: return insert_image<float>(ltens,limg,dtens,dimg,offsets,accum);
+ case R8: return insert_image<double>(ltens,limg,dtens,dimg,offsets,accum);
+ case C4: return insert_image<std::complex<float>>(ltens,limg,dtens,dimg,offsets,accum);
+ case C8: return insert_image<std::complex<double>>(ltens,limg,dtens,dimg,offsets,accum);
+ }
+ return 100;
+}
+
+/** Adds a permuted tensor body image to another one: dtens[] (+)= scale * ltens[]
+    (conjugation bits: 0:D, 1:L). A tensor copy is a non-accumulative addition with a unit scale. **/
+inline int tensor_image_add(const int * contr_ptrn, const talsh_tens_t * ltens, int limg, talsh_tens_t * dtens, int dimg,
+                            double scale_real, double scale_imag, int arg_conj, int accumulative)
+{
+ bool lconj,rconj;
+ const bool accum = (accumulative != NOPE);
+ if(ltens->data_kind[limg] != dtens->data_kind[dimg]) return 101;
+ conj_flags(arg_conj,&lconj,&rconj);
+ switch(dtens->data_kind[dimg]){
+ case R4: return add_image<float>(contr_ptrn,ltens,limg,dtens,dimg,scale_real,scale_imag,lconj,accum);
+ case R8: return add_image<double>(contr_ptrn,ltens,limg,dtens,dimg,scale_real,scale_imag,lconj,accum);
+ case C4: return add_image<std::complex<float>>(contr_ptrn,ltens,limg,dtens,dimg,scale_real,scale_imag,lconj,accum);
+ case C8: return add_image<std::complex<double>>(contr_ptrn,ltens,limg,dtens,dimg,scale_real,scale_imag,lconj,accum);
+ }
+ return 100;
+}
+
+/** Contracts two tensor body images: dtens[] (+)= scale * ltens[] * rtens[]
+    (conjugation bits: 0:D, 1:L, 2:R). **/
+inline int tensor_image_contract(const int * contr_ptrn, const talsh_tens_t * ltens, int limg,
+                                 const talsh_tens_t * rtens, int rimg, talsh_tens_t * dtens, int dimg,
+                                 double scale_real, double scale_imag, int arg_conj, int accumulative)
+{
+ bool lconj,rconj;
+ const bool accum = (accumulative != NOPE);
+ if(ltens->data_kind[limg] != dtens->data_kind[dimg] || rtens->data_kind[rimg] != dtens->data_kind[dimg]) return 101;
+ conj_flags(arg_conj,&lconj,&rconj);
+ switch(dtens->data_kind[dimg]){
+ case R4:
+  return contract_image<float>(contr_ptrn,ltens,limg,rtens,rimg,dtens,dimg,scale_real,scale_imag,lconj,rconj,accum);
+ case R8:
+  return contract_image<double>(contr_ptrn,ltens,limg,rtens,rimg,dtens,dimg,scale_real,scale_imag,lconj,rconj,accum);
+ case C4:
+  return contract_image<std::complex<float>>(contr_ptrn,ltens,limg,rtens,rimg,dtens,dimg,scale_real,scale_imag,lconj,rconj,accum);
+ case C8:
+  return contract_image<std::complex<double>>(contr_ptrn,ltens,limg,rtens,rimg,dtens,dimg,scale_real,scale_imag,lconj,rconj,accum);
+ }
+ return 100;
+}
+
+
+//ASYNCHRONOUS EXECUTION:
+
+/** Pool of Host worker threads executing submitted tasks in FIFO order.
+    The OpenMP threads of the Host are evenly partitioned among the workers,
+    thus independent tasks run concurrently on disjoint sets of cores. **/
+class TaskPool{
+
+public:
+
+ /** Spawns <num_workers> worker threads sharing <num_threads> OpenMP threads.
+     May throw std::system_error if a thread cannot be created. **/
+ TaskPool(int num_workers, int num_threads):
+  busy_(0), stop_(false)
+ {
+  if(num_workers < 1) num_workers = 1;
+  int worker_threads = num_threads / num_workers; if(worker_threads < 1) worker_threads = 1;
+  try{
+   for(int i = 0; i < num_workers; ++i) workers_.emplace_back(&TaskPool::run,this,worker_threads);
+  }catch(...){
+   shutdown(); throw;
+  }
+ }
+
+ TaskPool(const TaskPool &) = delete;
+ TaskPool & operator=(const TaskPool &) = delete;
+
+ /** Completes all submitted tasks and joins the worker threads. **/
+ ~TaskPool(){shutdown();}
+
+ int getNumWorkers() const{return static_cast<int>(workers_.size());}
+
+ /** Enqueues a task for execution by the first available worker. **/
+ void submit(std::function<void()> task){
+  {
+   std::lock_guard<std::mutex> lock(lock_);
+   queue_.emplace_back(std::move(task));
+  }
+  work_cv_.notify_one();
+ }
+
+ /** Blocks until all submitted tasks have been executed. **/
+ void wait(){
+  std::unique_lock<std::mutex> lock(lock_);
+  idle_cv_.wait(lock,[this]{return queue_.empty() && busy_ == 0;});
+ }
+
+ /** Returns the number of submitted tasks which have not been executed yet (queued or running). **/
+ int getNumPending(){
+  std::lock_guard<std::mutex> lock(lock_);
+  return static_cast<int>(queue_.size() + busy_);
+ }
+
+private:
+
+ void run(int num_threads){
+  omp_set_num_threads(num_threads); //OpenMP share of this worker
+  std::unique_lock<std::mutex> lock(lock_);
+  while(true){
+   work_cv_.wait(lock,[this]{return stop_ || !queue_.empty();});
+   if(queue_.empty()) break; //stop requested and no work left
+   std::function<void()> task = std::move(queue_.front()); queue_.pop_front();
+   ++busy_; lock.unlock();
+   task();
+   lock.lock(); --busy_;
+   if(queue_.empty() && busy_ == 0) idle_cv_.notify_all();
+  }
+ }
+
+ void shutdown(){
+  {
+   std::lock_guard<std::mutex> lock(lock_);
+   stop_ = true;
+  }
+  work_cv_.notify_all();
+  for(auto & worker: workers_) worker.join();
+  workers_.clear();
+ }
+
+ std::vector<std::thread> workers_;           //worker threads
+ std::deque<std::function<void()>> queue_;    //pending tasks
+ std::mutex lock_;                            //guards the queue and the counters
+ std::condition_variable work_cv_;            //signals new tasks (or stop)
+ std::condition_variable idle_cv_;            //signals that all tasks have been executed
+ unsigned int busy_;                          //number of tasks being executed
+ bool stop_;                                  //stop request
+};
+
+} //namespace cpu
+
+} //namespace talsh
+
+#endif //TENSOR_ALGEBRA_CPU_HPP_
@@ -3243,6 +3243,14 @@ __host__ int gpu_busy_least()
  return n;
 }
 
+__host__ int gpu_queue_depth(int gpu_num)
+/** Returns the number of unfinished tasks on a given GPU (non-negative) or -1 (invalid/inactive GPU). **/
+{
+ if(gpu_num < 0 || gpu_num >= MAX_GPUS_PER_NODE) return -1;
+ if(gpu_up[gpu_num] <= GPU_OFF) return -1;
+ return gpu_stats[gpu_num].tasks_submitted-(gpu_stats[gpu_num].tasks_completed+gpu_stats[gpu_num].tasks_deferred+gpu_stats[gpu_num].tasks_failed);
+}
+
 __host__ int gpu_in_focus(int gpu_num)
 /** If <gpu_num> is not passed here, returns the id of the current GPU in focus.
     If <gpu_num> is passed here, returns YEP if it is currently in focus, NOPE otherwise.
@@ -26,6 +26,7 @@
 #include <assert.h>
 
 #include "device_algebra.h"
+#include "mem_manager.h"
 #include "talsh.h"
 
 #ifdef __cplusplus
@@ -34,6 +35,9 @@
 #include <memory>
 #include <string>
 #include <complex>
+#include <vector>
+
+#include <omp.h>
 
 #include "talshxx.hpp"
 
@@ -42,6 +46,7 @@
 #ifdef __cplusplus
 extern "C"{
 #endif
+void test_mem_manager_c(int * ierr);
 void test_talsh_c(int * ierr);
 void test_talsh_cxx(int * ierr);
 void test_talsh_xl(int * ierr);
@@ -57,6 +62,92 @@ void test_nvtal_c(int * ierr);
 #endif
 
 
+void test_mem_manager_c(int * ierr)
+/** Host argument buffer allocator: Correctness and scaling of the allocation throughput across threads. **/
+{
+ const int NUM_OPS=200000; //number of allocation/deallocation pairs per thread
+ const int NUM_LIVE=4;     //number of simultaneously allocated entries per thread
+ size_t host_buffer_size = 64*1024*1024; //bytes
+ size_t blck_sizes[64];
+ int host_arg_max,errc;
+
+ *ierr=0;
+ errc=arg_buf_allocate(&host_buffer_size,&host_arg_max,-1,-1); if(errc){*ierr=1; return;}
+ int num_levels=get_blck_buf_sizes_host(blck_sizes);
+ const size_t small_size=blck_sizes[num_levels-1]; //lowest-level entry size
+ printf(" Host argument buffer: Size = %lu; Lowest-level entry size = %lu\n",host_buffer_size,small_size);
+
+//Telemetry of the Host argument buffer:
+ {
+  mem_telemetry_t tlm;
+  char *ptr,*huge_ptr; int entry,huge_entry;
+  const int host_id=talshFlatDevId(DEV_HOST,0);
+  errc=get_buf_entry_host(small_size,&ptr,&entry); if(errc){*ierr=8; arg_buf_deallocate(-1,-1); return;}
+  errc=get_buf_entry_host(host_buffer_size+1,&huge_ptr,&huge_entry); if(errc != DEVICE_UNABLE){*ierr=9; arg_buf_deallocate(-1,-1); return;}
+  errc=arg_buf_clean_host(); if(errc <= 0){*ierr=12; arg_buf_deallocate(-1,-1); return;} //returns cached entries to the buffer
+  errc=mem_get_telemetry(host_id,&tlm); if(errc){*ierr=10; arg_buf_deallocate(-1,-1); return;}
+  printf(" Telemetry: Largest free entry = %lu; Fragmentation = %f; Requests = %lld (rejected %lld/%lld)\n",
+         tlm.largest_free,tlm.fragmentation,tlm.num_requests,tlm.num_try_later,tlm.num_device_unable);
+  if(tlm.num_levels != num_levels || tlm.largest_free != blck_sizes[0] || tlm.fragmentation != 0.0 || tlm.level_free[0] != 2 ||
+     tlm.level_used[num_levels-1] != 1 || tlm.occ_size != small_size || tlm.num_requests != 2 ||
+     tlm.num_device_unable != 1 || tlm.granted_bytes != (long long)small_size || tlm.num_cached != 0){*ierr=11; arg_buf_deallocate(-1,-1); return;}
+  errc=free_buf_entry_host(entry); if(errc){*ierr=13; arg_buf_deallocate(-1,-1); return;}
+  errc=mem_reset_telemetry(host_id); if(errc){*ierr=14; arg_buf_deallocate(-1,-1); return;}
+ }
+
+//Concurrent allocation/deallocation of small entries:
+ const int max_threads=omp_get_max_threads();
+ for(int num_threads=1; num_threads<=max_threads; num_threads*=2){
+  int num_errors=0;
+  double tms=omp_get_wtime();
+#pragma omp parallel num_threads(num_threads) reduction(+:num_errors)
+  {
+   const int tid=omp_get_thread_num();
+   char *ptrs[NUM_LIVE]; int entries[NUM_LIVE];
+   for(int op=0; op<NUM_OPS; op+=NUM_LIVE){
+    for(int i=0; i<NUM_LIVE; ++i){
+     if(get_buf_entry_host(small_size/(i+1),&(ptrs[i]),&(entries[i])) != 0){num_errors++; entries[i]=-1; continue;}
+     ptrs[i][0]=(char)(tid); ptrs[i][small_size/(i+1)-1]=(char)(i);
+    }
+    for(int i=0; i<NUM_LIVE; ++i){
+     if(entries[i] < 0) continue;
+     if(ptrs[i][0] != (char)(tid) || ptrs[i][small_size/(i+1)-1] != (char)(i)) num_errors++; //entry is shared with another thread
+     if(free_buf_entry_host(entries[i]) != 0) num_errors++;
+    }
+   }
+  }
+  tms=omp_get_wtime()-tms;
+  printf(" %d threads: %e allocations/s (errors %d)\n",num_threads,((double)NUM_OPS)*((double)num_threads)/tms,num_errors);
+  if(num_errors != 0){*ierr=2; arg_buf_deallocate(-1,-1); return;}
+ }
+
+//Tiny entries are carved out of the lowest-level entries, thus more of them than of the lowest-level entries fit:
+ {
+  const int num_tiny=host_arg_max*4; int num_errors=0;
+  std::vector<char*> ptrs(num_tiny); std::vector<int> entries(num_tiny);
+  for(int i=0; i<num_tiny; ++i){
+   if(get_buf_entry_host(64+(i%2)*64,&(ptrs[i]),&(entries[i])) != 0){num_errors++; entries[i]=-1; continue;}
+   ptrs[i][0]=(char)(i); ptrs[i][64+(i%2)*64-1]=(char)(i);
+  }
+  for(int i=0; i<num_tiny; ++i){
+   if(entries[i] < 0) continue;
+   if(ptrs[i][0] != (char)(i) || ptrs[i][64+(i%2)*64-1] != (char)(i)) num_errors++; //overlapping entries
+   if(get_buf_entry_from_address(talshFlatDevId(DEV_HOST,0),ptrs[i]) != entries[i]) num_errors++; //handle lookup by address
+   if(free_buf_entry_host(entries[i]) != 0) num_errors++;
+  }
+  printf(" %d tiny entries in %d lowest-level entries (errors %d)\n",num_tiny,host_arg_max,num_errors);
+  if(num_errors != 0){*ierr=7; arg_buf_deallocate(-1,-1); return;}
+ }
+
+//The largest entry must still be available (cached small entries are returned to the buffer):
+ char *big_ptr; int big_entry;
+ errc=get_buf_entry_host(blck_sizes[0],&big_ptr,&big_entry); if(errc){*ierr=3; arg_buf_deallocate(-1,-1); return;}
+ errc=free_buf_entry_host(big_entry); if(errc){*ierr=4; arg_buf_deallocate(-1,-1); return;}
+ errc=arg_buf_clean_host(); if(errc){*ierr=5; arg_buf_deallocate(-1,-1); return;}
+ errc=arg_buf_deallocate(-1,-1); if(errc){*ierr=6; return;}
+ return;
+}
+
 void test_talsh_c(int * ierr)
 {
  const int VDIM_SIZE=40; //virtual
@@ -131,7 +222,7 @@ void test_talsh_c(int * ierr)
  errc=talshTaskClean(&task0); //clean TAL-SH task handle object to an empty state
  if(errc){*ierr=9; return;};
 
-//Execute a tensor contraction either on CPU (synchronously) or GPU (asynchronously):
+//Execute a tensor contraction asynchronously either on CPU or GPU:
 #ifndef NO_GPU
  int dev_kind = DEV_NVIDIA_GPU; //NVIDIA GPU devices
  int dev_num = 0; //specific device number (any from gpu_list[])
@@ -168,6 +259,169 @@ void test_talsh_c(int * ierr)
 #endif
  printf(" Tensor result was moved back to Host: Norm1 = %E: Correct = %E\n",talshTensorImageNorm1_cpu(&tens0),theor_norm1);
 
+//Small tensor operations on Host: Native C++ CP-TAL versus Fortran CP-TAL:
+ {
+  const int sdims[][3] = {{7,4,4},{4,7,4},{4,4,1}}; //D(a,b,c), L(d,a,c), R(b,d)
+  const size_t native_vol = talshSetHostNativeVolume(0); //Fortran CP-TAL first
+  talsh_tens_t stens[2][3];
+  std::complex<double> * sbody[2][3];
+  double max_diff = 0.0;
+  for(int impl=0; impl<2; ++impl){
+   for(int i=0; i<3; ++i){
+    errc = talshTensorClean(&(stens[impl][i])); if(errc){*ierr=19; return;};
+    errc = talshTensorConstruct(&(stens[impl][i]),C8,((i<2)?3:2),sdims[i],talshFlatDevId(DEV_HOST,0));
+    if(errc){*ierr=19; return;};
+    errc = talshTensorGetBodyAccess(&(stens[impl][i]),(void**)&(sbody[impl][i]),C8,0,DEV_HOST); if(errc){*ierr=19; return;};
+    for(size_t l=0; l<talshTensorVolume(&(stens[impl][i])); ++l) sbody[impl][i][l]=std::complex<double>((l%7)*0.1,(l%3)*0.2);
+   }
+   if(impl == 1) talshSetHostNativeVolume(native_vol); //native C++ CP-TAL next
+   errc = talshTensorContract("D(a,b,c)+=L(d,a,c)*R+(b,d)",&(stens[impl][0]),&(stens[impl][1]),&(stens[impl][2]),
+                              0.5,0.25,0,DEV_HOST,COPY_TTT,NOPE);
+   if(errc){*ierr=20; return;};
+   errc = talshTensorCopy("D(a,b,c)=L+(b,a,c)",&(stens[impl][0]),&(stens[impl][1]),0,DEV_HOST); //permuted copy
+   if(errc){*ierr=21; return;};
+  }
+  for(int i=0; i<2; ++i){
+   for(size_t l=0; l<talshTensorVolume(&(stens[0][i])); ++l) max_diff=std::max(max_diff,std::abs(sbody[0][i][l]-sbody[1][i][l]));
+  }
+  printf(" Small tensor operations on Host: Native C++ CP-TAL deviates from Fortran CP-TAL by %E\n",max_diff);
+  for(int impl=0; impl<2; ++impl){for(int i=0; i<3; ++i) errc = talshTensorDestruct(&(stens[impl][i]));}
+  if(max_diff > 1e-13){*ierr=22; return;};
+ }
+
+//Independent non-blocking tensor contractions on Host (executed concurrently by the Host workers),
+//first above the native C++ CP-TAL volume threshold (Fortran CP-TAL in the Host task pool), then below it:
+ {
+  const int NUM_TASKS = 8;
+  const int hdims[] = {24,24};
+  const size_t native_vol = talshSetHostNativeVolume(0); //all Host tensors are above the threshold now
+  talsh_tens_t htens[NUM_TASKS][3], href;
+  talsh_task_t htasks[NUM_TASKS];
+  int hstats[NUM_TASKS];
+  double * hbody;
+  double max_diff = 0.0;
+  for(int route=0; route<2; ++route){
+   for(int i=0; i<NUM_TASKS; ++i){
+    for(int k=0; k<3; ++k){
+     errc = talshTensorClean(&(htens[i][k])); if(errc){*ierr=23; return;};
+     errc = talshTensorConstruct(&(htens[i][k]),R8,2,hdims,talshFlatDevId(DEV_HOST,0),NULL,-1,NULL,(k==0)?0.0:0.01*(i+k));
+     if(errc){*ierr=23; return;};
+    }
+    errc = talshTaskClean(&(htasks[i])); if(errc){*ierr=23; return;};
+   }
+   errc = talshTensorClean(&href); if(errc){*ierr=23; return;};
+   errc = talshTensorConstruct(&href,R8,2,hdims,talshFlatDevId(DEV_HOST,0),NULL,-1,NULL,0.0); if(errc){*ierr=23; return;};
+   for(int i=0; i<NUM_TASKS; ++i){ //all contractions are issued before any of them is waited upon
+    errc = talshTensorContract("D(a,b)+=L(c,a)*R(c,b)",&(htens[i][0]),&(htens[i][1]),&(htens[i][2]),
+                               1.0,0.0,0,DEV_HOST,COPY_MTT,YEP,&(htasks[i]));
+    if(errc){*ierr=24; return;};
+   }
+   errc = talshTasksWait(NUM_TASKS,htasks,hstats); if(errc){*ierr=25; return;};
+   for(int i=0; i<NUM_TASKS; ++i){
+    if(hstats[i] != TALSH_TASK_COMPLETED){*ierr=25; return;};
+    errc = talshTaskDestruct(&(htasks[i])); if(errc){*ierr=25; return;};
+    errc = talshTensorContract("D(a,b)=L(c,a)*R(c,b)",&href,&(htens[i][1]),&(htens[i][2]),1.0,0.0,0,DEV_HOST,COPY_MTT,NOPE);
+    if(errc){*ierr=26; return;};
+    max_diff = std::max(max_diff,std::abs(talshTensorImageNorm1_cpu(&(htens[i][0]))-talshTensorImageNorm1_cpu(&href)));
+    errc = talshTensorGetBodyAccess(&(htens[i][0]),(void**)&hbody,R8,0,DEV_HOST); if(errc){*ierr=26; return;};
+    for(size_t l=0; l<talshTensorVolume(&(htens[i][0])); ++l){
+     max_diff = std::max(max_diff,std::abs(hbody[l]-hdims[0]*1e-4*(i+1)*(i+2)));
+    }
+   }
+   printf(" Non-blocking tensor contractions on Host (%s CP-TAL): Max deviation = %E\n",(route==0)?"Fortran":"native C++",max_diff);
+   errc = talshTensorDestruct(&href);
+   for(int i=0; i<NUM_TASKS; ++i){for(int k=0; k<3; ++k) errc = talshTensorDestruct(&(htens[i][k]));}
+   if(route == 0) talshSetHostNativeVolume(native_vol); //native C++ CP-TAL next
+  }
+  if(max_diff > 1e-12){*ierr=27; return;};
+ }
+
+//Batched small tensor contractions and additions on Host (two contractions per destination, two shapes):
+ {
+  const int NUM_OPS = 16;
+  const int bdims[2][2] = {{6,6},{9,9}};
+  talsh_tens_t btens[NUM_OPS][3], bref[NUM_OPS/2];
+  talsh_tens_t *bd[NUM_OPS], *bl[NUM_OPS], *br[NUM_OPS];
+  for(int i=0; i<NUM_OPS; ++i){
+   const int * dims = bdims[(i/2)%2];
+   for(int k=0; k<3; ++k){
+    errc = talshTensorClean(&(btens[i][k])); if(errc){*ierr=28; return;};
+    errc = talshTensorConstruct(&(btens[i][k]),R8,2,dims,talshFlatDevId(DEV_HOST,0),NULL,-1,NULL,0.01*(i+k+1));
+    if(errc){*ierr=28; return;};
+   }
+   bd[i] = &(btens[i-i%2][0]); bl[i] = &(btens[i][1]); br[i] = &(btens[i][2]);
+  }
+  for(int i=0; i<NUM_OPS/2; ++i){ //reference: regular tensor operations
+   errc = talshTensorClean(&(bref[i])); if(errc){*ierr=28; return;};
+   errc = talshTensorConstruct(&(bref[i]),R8,2,bdims[i%2],talshFlatDevId(DEV_HOST,0),NULL,-1,NULL,0.01*(2*i+1));
+   if(errc){*ierr=28; return;};
+   for(int j=2*i; j<2*i+2; ++j){
+    errc = talshTensorContract("D(a,b)+=L(a,c)*R(c,b)",&(bref[i]),bl[j],br[j],0.5,0.0,0,DEV_HOST);
+    if(errc){*ierr=29; return;};
+    errc = talshTensorAdd("D(a,b)+=L(a,b)",&(bref[i]),bl[j],2.0,0.0,0,DEV_HOST);
+    if(errc){*ierr=29; return;};
+   }
+  }
+  errc = talshTensorContractBatch("D(a,b)+=L(a,c)*R(c,b)",NUM_OPS,bd,bl,br,0.5);
+  if(errc){*ierr=30; return;};
+  errc = talshTensorAddBatch("D(a,b)+=L(a,b)",NUM_OPS,bd,bl,2.0);
+  if(errc){*ierr=30; return;};
+  double max_diff = 0.0;
+  for(int i=0; i<NUM_OPS/2; ++i){ //element-wise comparison against the regular tensor operations
+   double *bbody, *rbody;
+   errc = talshTensorGetBodyAccess(bd[2*i],(void**)&bbody,R8,0,DEV_HOST); if(errc){*ierr=31; return;};
+   errc = talshTensorGetBodyAccess(&(bref[i]),(void**)&rbody,R8,0,DEV_HOST); if(errc){*ierr=31; return;};
+   for(size_t l=0; l<talshTensorVolume(&(bref[i])); ++l) max_diff = std::max(max_diff,std::abs(bbody[l]-rbody[l]));
+  }
+  printf(" Batched tensor operations on Host: Max deviation = %E\n",max_diff);
+  for(int i=0; i<NUM_OPS/2; ++i) errc = talshTensorDestruct(&(bref[i]));
+  for(int i=0; i<NUM_OPS; ++i){for(int k=0; k<3; ++k) errc = talshTensorDestruct(&(btens[i][k]));}
+  if(max_diff > 1e-12){*ierr=31; return;};
+ }
+
+//Online performance model: Save/load round trip and the resulting choice of the Host CP-TAL implementation:
+ {
+  const int pdims[] = {8,8};
+  const char * model_file = "test_talsh_perf_model.txt";
+  const char * probe_file = "test_talsh_perf_probe.txt";
+  const size_t native_vol = talshSetHostNativeVolume(64); //tensor volume within the exploration range of both implementations
+  talsh_tens_t ptens[3];
+  for(int k=0; k<3; ++k){
+   errc = talshTensorClean(&(ptens[k])); if(errc){*ierr=32; return;};
+   errc = talshTensorConstruct(&(ptens[k]),R8,2,pdims,talshFlatDevId(DEV_HOST,0),NULL,-1,NULL,0.01*(k+1));
+   if(errc){*ierr=32; return;};
+  }
+  for(int i=0; i<8; ++i){ //explore and record both CP-TAL implementations
+   errc = talshTensorContract("D(a,b)+=L(c,a)*R(c,b)",&(ptens[0]),&(ptens[1]),&(ptens[2]),1.0,0.0,0,DEV_HOST);
+   if(errc){*ierr=33; return;};
+  }
+  int native = talshHostNative(TALSH_TENSOR_CONTRACT,&(ptens[0]),&(ptens[1]),&(ptens[2]));
+  if(native != YEP && native != NOPE){*ierr=33; return;};
+  errc = talshPerfModelSave(model_file); if(errc){*ierr=34; return;};
+  //Reload the saved model with one kernel variant (lowest byte of the key: 0:Fortran, 1:native) made much slower:
+  int chosen[2] = {-1,-1};
+  for(int slow=0; slow<2; ++slow){
+   FILE * fin = fopen(model_file,"r"); if(fin == NULL){*ierr=34; return;};
+   FILE * fout = fopen(probe_file,"w"); if(fout == NULL){fclose(fin); *ierr=34; return;};
+   unsigned long long int key; double count, sec_unit, failures;
+   while(fscanf(fin,"%llu %lf %lf %lf",&key,&count,&sec_unit,&failures) == 4){
+    if((int)(key&0xFFULL) == slow) sec_unit *= 1e6;
+    fprintf(fout,"%llu %.1f %.17e %.1f\n",key,count,sec_unit,failures);
+   }
+   fclose(fout); fclose(fin);
+   errc = talshPerfModelLoad(probe_file); if(errc){*ierr=34; return;};
+   chosen[slow] = talshHostNative(TALSH_TENSOR_CONTRACT,&(ptens[0]),&(ptens[1]),&(ptens[2]));
+  }
+  errc = talshPerfModelLoad(model_file); if(errc){*ierr=34; return;}; //restore the saved model
+  if(talshHostNative(TALSH_TENSOR_CONTRACT,&(ptens[0]),&(ptens[1]),&(ptens[2])) != native){*ierr=35; return;};
+  remove(probe_file); remove(model_file);
+  talshSetHostNativeVolume(native_vol);
+  for(int k=0; k<3; ++k) errc = talshTensorDestruct(&(ptens[k]));
+  printf(" Online performance model: Native C++ CP-TAL chosen: %d (slower Fortran CP-TAL: %d, slower native CP-TAL: %d)\n",
+         native,chosen[0],chosen[1]);
+  if(chosen[0] != YEP || chosen[1] != NOPE){*ierr=35; return;};
+ }
+
 //Unregister tensor blocks with TAL-SH:
  errc=talshTensorDestruct(&tens2); if(errc){*ierr=15; return;};
  errc=talshTensorDestruct(&tens1); if(errc){*ierr=16; return;};
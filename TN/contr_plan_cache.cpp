@@ -0,0 +1,237 @@
+/** C++ adapters for ExaTENSOR: Tensor contraction plan cache
+
+!AUTHOR: Dmitry I. Lyakh (Liakh): quant4me@gmail.com
+!REVISION: 2020/07/14
+
+!Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
+!Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
+
+!This file is part of ExaTensor.
+
+!ExaTensor is free software: you can redistribute it and/or modify
+!it under the terms of the GNU Lesser General Public License as published
+!by the Free Software Foundation, either version 3 of the License, or
+!(at your option) any later version.
+
+!ExaTensor is distributed in the hope that it will be useful,
+!but WITHOUT ANY WARRANTY; without even the implied warranty of
+!MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+!GNU Lesser General Public License for more details.
+
+!You should have received a copy of the GNU Lesser General Public License
+!along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
+
+**/
+
+#include "contr_plan_cache.hpp"
+
+#include <fstream>
+#include <algorithm>
+
+namespace exatensor {
+
+/** Assigns the intermediate tensors to a small set of reusable memory slots:
+    The tensor contractions are scanned in order, each intermediate tensor
+    taking the smallest free slot large enough to hold it, otherwise the
+    largest free slot (which is then enlarged), otherwise a new slot. A slot
+    becomes free once the consumer of its current intermediate tensor has passed. **/
+void ContractionPlan::assignSlots()
+{
+ const auto numContractions = Steps.size();
+ std::vector<std::size_t> consumer(numContractions,numContractions); //intermediate tensor --> its consuming tensor contraction
+ for(std::size_t contrNum = 0; contrNum < numContractions; ++contrNum){
+  for(const auto operand: Steps[contrNum].Operands) if(operand >= 0) consumer[operand] = contrNum;
+ }
+ SlotVolumes.clear();
+ std::vector<std::size_t> slotFree; //tensor contraction after which each slot becomes free
+ for(std::size_t contrNum = 0; contrNum < numContractions; ++contrNum){
+  auto & step = Steps[contrNum];
+  step.Slot = -1;
+  if(contrNum == numContractions - 1) break; //output tensor has its own body
+  std::size_t vol = 1; for(const auto dim: step.Dims) vol *= static_cast<std::size_t>(dim);
+  int bestFit = -1, largest = -1;
+  for(int slot = 0; slot < static_cast<int>(SlotVolumes.size()); ++slot){
+   if(slotFree[slot] >= contrNum) continue; //slot is still occupied
+   if(SlotVolumes[slot] >= vol){
+    if(bestFit < 0 || SlotVolumes[slot] < SlotVolumes[bestFit]) bestFit = slot;
+   }else{
+    if(largest < 0 || SlotVolumes[slot] > SlotVolumes[largest]) largest = slot;
+   }
+  }
+  if(bestFit < 0){
+   if(largest >= 0){
+    bestFit = largest; SlotVolumes[largest] = vol;
+   }else{
+    bestFit = static_cast<int>(SlotVolumes.size()); SlotVolumes.emplace_back(vol); slotFree.emplace_back(0);
+   }
+  }
+  step.Slot = bestFit; slotFree[bestFit] = consumer[contrNum];
+ }
+ return;
+}
+
+/** Returns the total volume of all memory slots (tensor elements). **/
+std::size_t ContractionPlan::getArenaVolume() const
+{
+ std::size_t vol = 0;
+ for(const auto slotVol: SlotVolumes) vol += slotVol;
+ return vol;
+}
+
+/** Returns TRUE if the plan is consistent for a tensor network with a given number of r.h.s. tensors. **/
+bool ContractionPlan::isValid(unsigned int numTensors) const
+{
+ const auto numContractions = Steps.size();
+ if(numTensors < 2 || ContrSeq.size() != numTensors - 1 || numContractions != ContrSeq.size()) return false;
+ for(std::size_t contrNum = 0; contrNum < numContractions; ++contrNum){ //tensor ids within the reduced tensor network
+  const auto & contrPair = ContrSeq[contrNum];
+  if(contrPair.first == 0 || contrPair.first >= contrPair.second || contrPair.second > numTensors - contrNum) return false;
+ }
+ std::vector<std::size_t> consumer(numContractions,numContractions); //intermediate tensor --> its consuming tensor contraction
+ std::vector<bool> consumed(numTensors + 1,false);                   //r.h.s. tensor --> consumed
+ for(std::size_t contrNum = 0; contrNum < numContractions; ++contrNum){
+  for(const auto operand: Steps[contrNum].Operands){
+   if(operand < 0){
+    if(static_cast<long long>(-operand) > static_cast<long long>(numTensors) || consumed[-operand]) return false;
+    consumed[-operand] = true;
+   }else{
+    if(static_cast<std::size_t>(operand) >= contrNum || consumer[operand] != numContractions) return false;
+    consumer[operand] = contrNum;
+   }
+  }
+  for(const auto dim: Steps[contrNum].Dims) if(dim <= 0) return false;
+ }
+ std::vector<std::size_t> slotFree(SlotVolumes.size(),0); //tensor contraction after which each slot becomes free
+ std::vector<bool> slotUsed(SlotVolumes.size(),false);
+ for(std::size_t contrNum = 0; contrNum < numContractions; ++contrNum){
+  const auto & step = Steps[contrNum];
+  if(contrNum == numContractions - 1) return (step.Slot == -1 && consumer[contrNum] == numContractions); //output tensor
+  if(consumer[contrNum] == numContractions) return false; //intermediate tensor is never consumed
+  if(step.Slot < 0 || static_cast<std::size_t>(step.Slot) >= SlotVolumes.size()) return false;
+  std::size_t vol = 1; for(const auto dim: step.Dims) vol *= static_cast<std::size_t>(dim);
+  if(vol > SlotVolumes[step.Slot]) return false;
+  if(slotUsed[step.Slot] && slotFree[step.Slot] >= contrNum) return false; //slot is still occupied
+  slotUsed[step.Slot] = true; slotFree[step.Slot] = consumer[contrNum];
+ }
+ return false;
+}
+
+/** Returns the process-wide tensor contraction plan cache. **/
+ContrPlanCache & ContrPlanCache::getCache()
+{
+ static ContrPlanCache cache;
+ return cache;
+}
+
+/** Retrieves a cached tensor contraction plan, returns FALSE if not found. **/
+bool ContrPlanCache::findPlan(const std::string & key,
+                              ContractionPlan & plan) const
+{
+ std::lock_guard<std::mutex> lock(Lock);
+ auto pos = Plans.find(key);
+ if(pos == Plans.end()) return false;
+ plan = pos->second;
+ return true;
+}
+
+/** Returns the number of cached tensor contraction plans. **/
+std::size_t ContrPlanCache::getNumPlans() const
+{
+ std::lock_guard<std::mutex> lock(Lock);
+ return Plans.size();
+}
+
+/** Saves all cached tensor contraction plans into a file, returns 0 on success.
+    The file format is textual: A header line with the number of plans followed by
+    KEY, SEQUENCE, SLOTS and STEP records of each plan (topology keys contain no blanks). **/
+int ContrPlanCache::save(const std::string & fileName) const
+{
+ std::ofstream file(fileName);
+ if(!file) return -1;
+ std::lock_guard<std::mutex> lock(Lock);
+ file << "ExaTENSOR_CONTRACTION_PLANS " << Plans.size() << std::endl;
+ for(const auto & entry: Plans){
+  const auto & plan = entry.second;
+  file << "KEY " << entry.first << std::endl;
+  file << "SEQUENCE " << plan.ContrSeq.size();
+  for(const auto & contrPair: plan.ContrSeq) file << " " << contrPair.first << " " << contrPair.second;
+  file << std::endl;
+  file << "SLOTS " << plan.SlotVolumes.size();
+  for(const auto slotVol: plan.SlotVolumes) file << " " << slotVol;
+  file << std::endl;
+  for(const auto & step: plan.Steps){
+   file << "STEP " << step.Operands[0] << " " << step.Operands[1] << " " << step.Slot << " " << step.Dims.size();
+   for(const auto dim: step.Dims) file << " " << dim;
+   file << " " << step.ContrPtrnDig.size();
+   for(const auto ptrn: step.ContrPtrnDig) file << " " << ptrn;
+   file << " " << step.ContrPtrnSym << std::endl;
+  }
+ }
+ file.flush();
+ if(!file) return -2;
+ return 0;
+}
+
+/** Caches a tensor contraction plan (replaces the previous one with the same key). **/
+void ContrPlanCache::storePlan(const std::string & key,
+                               const ContractionPlan & plan)
+{
+ std::lock_guard<std::mutex> lock(Lock);
+ Plans[key] = plan;
+ return;
+}
+
+/** Loads tensor contraction plans from a file, returns 0 on success.
+    The loaded plans are added to the already cached ones, except the plans
+    which are inconsistent with the tensor network given by their topology key
+    (the number of tensors is the number of ';' separators in the key). **/
+int ContrPlanCache::load(const std::string & fileName)
+{
+ std::ifstream file(fileName);
+ if(!file) return -1;
+ std::string tag;
+ std::size_t numPlans = 0;
+ file >> tag >> numPlans;
+ if(!file || tag != "ExaTENSOR_CONTRACTION_PLANS") return -2;
+ std::unordered_map<std::string,ContractionPlan> plans;
+ for(std::size_t i = 0; i < numPlans; ++i){
+  std::string key;
+  ContractionPlan plan;
+  std::size_t numContr = 0;
+  file >> tag >> key; if(!file || tag != "KEY") return -2;
+  file >> tag >> numContr; if(!file || tag != "SEQUENCE") return -2;
+  plan.ContrSeq.resize(numContr);
+  for(auto & contrPair: plan.ContrSeq) file >> contrPair.first >> contrPair.second;
+  std::size_t numSlots = 0;
+  file >> tag >> numSlots; if(!file || tag != "SLOTS") return -2;
+  plan.SlotVolumes.resize(numSlots);
+  for(auto & slotVol: plan.SlotVolumes) file >> slotVol;
+  plan.Steps.resize(numContr);
+  for(auto & step: plan.Steps){
+   std::size_t len = 0;
+   file >> tag >> step.Operands[0] >> step.Operands[1] >> step.Slot >> len; if(!file || tag != "STEP") return -2;
+   step.Dims.resize(len);
+   for(auto & dim: step.Dims) file >> dim;
+   file >> len;
+   step.ContrPtrnDig.resize(len);
+   for(auto & ptrn: step.ContrPtrnDig) file >> ptrn;
+   file >> step.ContrPtrnSym;
+  }
+  if(!file) return -2;
+  const auto numTensors = std::count(key.cbegin(),key.cend(),';'); //r.h.s. tensors plus the output tensor
+  if(numTensors > 0 && plan.isValid(static_cast<unsigned int>(numTensors - 1))) plans[key] = std::move(plan);
+ }
+ std::lock_guard<std::mutex> lock(Lock);
+ for(auto & entry: plans) Plans[entry.first] = std::move(entry.second);
+ return 0;
+}
+
+/** Clears the cache. **/
+void ContrPlanCache::clear()
+{
+ std::lock_guard<std::mutex> lock(Lock);
+ Plans.clear();
+ return;
+}
+
+} //end namespace exatensor
@@ -0,0 +1,111 @@
+/** C++ adapters for ExaTENSOR: Tensor contraction plan cache
+
+!AUTHOR: Dmitry I. Lyakh (Liakh): quant4me@gmail.com
+!REVISION: 2020/07/14
+
+!Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
+!Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
+
+!This file is part of ExaTensor.
+
+!ExaTensor is free software: you can redistribute it and/or modify
+!it under the terms of the GNU Lesser General Public License as published
+!by the Free Software Foundation, either version 3 of the License, or
+!(at your option) any later version.
+
+!ExaTensor is distributed in the hope that it will be useful,
+!but WITHOUT ANY WARRANTY; without even the implied warranty of
+!MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+!GNU Lesser General Public License for more details.
+
+!You should have received a copy of the GNU Lesser General Public License
+!along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
+
+**/
+
+#ifndef EXA_CONTR_PLAN_CACHE_H_
+#define EXA_CONTR_PLAN_CACHE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+#include "contr_seq_optimizer.hpp"
+
+namespace exatensor {
+
+/** Single tensor contraction of a tensor contraction plan. **/
+struct ContrPlanStep{
+ int Operands[2];               //left/right input tensor: >=0: producing tensor contraction; <0: -(r.h.s. tensor id)
+ std::vector<int> ContrPtrnDig; //digital tensor contraction pattern
+ std::string ContrPtrnSym;      //symbolic tensor contraction pattern
+ std::vector<int> Dims;         //dimension extents of the destination tensor
+ int Slot;                      //memory slot of the destination tensor (-1 for the output tensor)
+};
+
+/** Tensor contraction plan: Tensor contraction sequence together with
+ all data derived from it which are needed for the numerical evaluation
+ of a tensor network (tensor contraction patterns, intermediate shapes
+ and the static placement of the intermediate tensors in memory slots). **/
+struct ContractionPlan{
+ ContractionSequence ContrSeq;          //tensor contraction sequence
+ std::vector<ContrPlanStep> Steps;      //tensor contractions (in the order of the contraction sequence)
+ std::vector<std::size_t> SlotVolumes;  //volume of each memory slot (tensor elements)
+
+ /** Assigns the intermediate tensors to a small set of reusable memory slots (static memory
+     planning, like register allocation): An intermediate tensor is live from its production
+     until its consuming tensor contraction, and intermediate tensors with disjoint lifetimes
+     in the order of the contraction sequence share the same slot. Each slot is owned by its
+     intermediate tensors in the order of the contraction sequence. **/
+ void assignSlots();
+ /** Returns the total volume of all memory slots (tensor elements). **/
+ std::size_t getArenaVolume() const;
+ /** Returns TRUE if the plan is consistent for a tensor network with a given number of r.h.s. tensors:
+     Tensor ids, operands and memory slots are within their ranges, each intermediate tensor is consumed
+     exactly once after its production, and the intermediate tensors sharing a slot fit into it
+     and do not live at the same time. **/
+ bool isValid(unsigned int numTensors) const; //in: number of r.h.s. tensors in the tensor network
+};
+
+/** Process-wide cache of tensor contraction plans keyed by the topology of tensor networks
+ (tensor connections and leg extents, see TensorNetwork<T>::getTopologyKey()). Repeated
+ evaluations of tensor networks of the same structure reuse the cached plans, thus
+ skipping the planning stage. The cache can be saved to and loaded from a file. **/
+class ContrPlanCache{
+
+public:
+
+ /** Returns the process-wide tensor contraction plan cache. **/
+ static ContrPlanCache & getCache();
+
+//Accessors:
+ /** Retrieves a cached tensor contraction plan, returns FALSE if not found. **/
+ bool findPlan(const std::string & key,       //in: topology key of the tensor network
+               ContractionPlan & plan) const; //out: tensor contraction plan
+ /** Returns the number of cached tensor contraction plans. **/
+ std::size_t getNumPlans() const;
+ /** Saves all cached tensor contraction plans into a file, returns 0 on success. **/
+ int save(const std::string & fileName) const; //in: file name
+
+//Mutators:
+ /** Caches a tensor contraction plan (replaces the previous one with the same key). **/
+ void storePlan(const std::string & key,      //in: topology key of the tensor network
+                const ContractionPlan & plan); //in: tensor contraction plan
+ /** Loads tensor contraction plans from a file, returns 0 on success
+     (inconsistent plans are skipped, thus they will be rebuilt). **/
+ int load(const std::string & fileName); //in: file name
+ /** Clears the cache. **/
+ void clear();
+
+private:
+
+ mutable std::mutex Lock;                                //lock protecting the cache
+ std::unordered_map<std::string,ContractionPlan> Plans; //cached tensor contraction plans: topology key --> plan
+
+};
+
+} //end namespace exatensor
+
+#endif //EXA_CONTR_PLAN_CACHE_H_
@@ -0,0 +1,942 @@
+/** C++ adapters for ExaTENSOR: Tensor contraction sequence optimization
+
+!AUTHOR: Dmitry I. Lyakh (Liakh): quant4me@gmail.com
+!REVISION: 2020/07/14
+
+!Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
+!Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
+
+!This file is part of ExaTensor.
+
+!ExaTensor is free software: you can redistribute it and/or modify
+!it under the terms of the GNU Lesser General Public License as published
+!by the Free Software Foundation, either version 3 of the License, or
+!(at your option) any later version.
+
+!ExaTensor is distributed in the hope that it will be useful,
+!but WITHOUT ANY WARRANTY; without even the implied warranty of
+!MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+!GNU Lesser General Public License for more details.
+
+!You should have received a copy of the GNU Lesser General Public License
+!along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
+
+**/
+
+#include "contr_seq_optimizer.hpp"
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <chrono>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace exatensor {
+
+//Internal machinery (compact representation of partially contracted tensor networks):
+namespace {
+
+using BitWord = std::uint64_t;
+const unsigned int BITS_PER_WORD = 64;
+
+/** Layout of a compact configuration (shared by all configurations of a given contraction graph). **/
+struct ContrLayout{
+ unsigned int NumTensors;     //number of r.h.s. tensors
+ unsigned int TensWords;      //number of words in the tensor bitset
+ unsigned int EdgeWords;      //number of words in the edge bitset
+ unsigned int RowWords;       //number of words per tensor group: TensWords + EdgeWords
+ std::vector<double> Extents; //edge extents
+ ContrCostModel CostModel;    //cost model of tensor contractions
+ double MaxVolume;            //max volume of an intermediate tensor
+
+ ContrLayout(const ContractionGraph & graph, const ContrCostModel & costModel):
+  NumTensors(graph.getNumTensors()), CostModel(costModel), MaxVolume(costModel.getMaxVolume())
+ {
+  const auto numEdges = graph.getNumEdges();
+  TensWords = (NumTensors + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  EdgeWords = (numEdges + BITS_PER_WORD - 1) / BITS_PER_WORD; if(EdgeWords == 0) EdgeWords = 1;
+  RowWords = TensWords + EdgeWords;
+  for(unsigned int i = 0; i < numEdges; ++i) Extents.emplace_back(static_cast<double>(graph.getEdge(i).Extent));
+ }
+};
+
+/** Compact configuration of a partially contracted tensor network:
+ An ordered list of tensor groups (intermediate tensors), each group being
+ a row of the merged tensor bitset followed by the bitset of its uncontracted
+ legs. The groups are always ordered by their smallest original tensor id,
+ which coincides with the TensorNetwork<T>::contractTensors() numeration,
+ thus making the configuration canonical (suitable for memoization). **/
+struct ContrConfig{
+ std::vector<BitWord> Rows;   //group rows: [tensor bitset|edge bitset] per group
+ std::vector<double> Volumes; //cached volume of each group (intermediate tensor)
+ ContractionSequence Seq;     //contraction sequence leading to this configuration
+ double Cost;                 //accumulated contraction cost
+
+ unsigned int getNumGroups() const {return static_cast<unsigned int>(Volumes.size());}
+};
+
+/** Candidate contraction in a given configuration (lightweight). **/
+struct ContrCandidate{
+ double Cost;         //accumulated contraction cost after this contraction
+ unsigned int Parent; //parental configuration
+ unsigned int Left;   //1st contracted group: [0..numGroups-1]
+ unsigned int Right;  //2nd contracted group: (Left..numGroups-1]
+
+ bool operator<(const ContrCandidate & another) const {
+  if(Cost != another.Cost) return (Cost < another.Cost);
+  if(Parent != another.Parent) return (Parent < another.Parent);
+  if(Left != another.Left) return (Left < another.Left);
+  return (Right < another.Right);
+ }
+};
+
+/** Sets up the initial configuration (no contractions performed). **/
+void initConfig(const ContrLayout & layout, const ContractionGraph & graph, ContrConfig & config)
+{
+ const auto numTensors = layout.NumTensors;
+ config.Rows.assign(static_cast<std::size_t>(numTensors) * layout.RowWords,0);
+ config.Volumes.assign(numTensors,1.0);
+ config.Seq.clear();
+ config.Cost = 0.0;
+ for(unsigned int i = 0; i < numTensors; ++i){
+  BitWord * row = &(config.Rows[static_cast<std::size_t>(i) * layout.RowWords]);
+  row[i / BITS_PER_WORD] |= (BitWord{1} << (i % BITS_PER_WORD));
+  BitWord * edges = row + layout.TensWords;
+  for(const auto edgeId: graph.getTensorEdges(i+1)) edges[edgeId / BITS_PER_WORD] ^= (BitWord{1} << (edgeId % BITS_PER_WORD));
+  double vol = 1.0;
+  for(unsigned int w = 0; w < layout.EdgeWords; ++w){
+   BitWord bits = edges[w];
+   while(bits != 0){
+    vol *= layout.Extents[w * BITS_PER_WORD + __builtin_ctzll(bits)];
+    bits &= (bits - 1);
+   }
+  }
+  config.Volumes[i] = vol;
+ }
+ return;
+}
+
+/** Returns the volume of the legs shared by two groups of a configuration. **/
+inline double sharedVolume(const ContrLayout & layout, const ContrConfig & config, unsigned int left, unsigned int right)
+{
+ const BitWord * ledges = &(config.Rows[static_cast<std::size_t>(left) * layout.RowWords + layout.TensWords]);
+ const BitWord * redges = &(config.Rows[static_cast<std::size_t>(right) * layout.RowWords + layout.TensWords]);
+ double vol = 1.0;
+ for(unsigned int w = 0; w < layout.EdgeWords; ++w){
+  BitWord bits = ledges[w] & redges[w];
+  while(bits != 0){
+   vol *= layout.Extents[w * BITS_PER_WORD + __builtin_ctzll(bits)];
+   bits &= (bits - 1);
+  }
+ }
+ return vol;
+}
+
+/** Returns TRUE if two groups of a configuration share at least one leg. **/
+inline bool sharesLegs(const ContrLayout & layout, const ContrConfig & config, unsigned int left, unsigned int right)
+{
+ const BitWord * ledges = &(config.Rows[static_cast<std::size_t>(left) * layout.RowWords + layout.TensWords]);
+ const BitWord * redges = &(config.Rows[static_cast<std::size_t>(right) * layout.RowWords + layout.TensWords]);
+ for(unsigned int w = 0; w < layout.EdgeWords; ++w) if((ledges[w] & redges[w]) != 0) return true;
+ return false;
+}
+
+/** Returns the cost of a tensor contraction under the cost model of the layout
+    (infinity if the intermediate tensor produced does not fit into the memory limit). **/
+inline double contrCost(const ContrLayout & layout, double lVol, double rVol, double cVol, bool intermediate)
+{
+ //Tensor volumes are integers, thus the rounding errors of the floating-point volume arithmetic are tolerated:
+ if(intermediate && lVol * rVol / (cVol * cVol) > layout.MaxVolume * (1.0 + 1e-9)) return std::numeric_limits<double>::infinity();
+ return layout.CostModel.getCost(lVol,rVol,cVol);
+}
+
+/** Returns the cost of contracting two groups of a configuration (same as TensorNetwork<T>::getContractionCost). **/
+inline double pairCost(const ContrLayout & layout, const ContrConfig & config, unsigned int left, unsigned int right)
+{
+ return contrCost(layout,config.Volumes[left],config.Volumes[right],sharedVolume(layout,config,left,right),
+                  config.getNumGroups() > 2);
+}
+
+/** Produces a child configuration by contracting two groups of the parental configuration. **/
+void contractGroups(const ContrLayout & layout, const ContrConfig & parent, unsigned int left, unsigned int right,
+                    ContrConfig & child)
+{
+ assert(left < right && right < parent.getNumGroups());
+ const auto rowWords = layout.RowWords;
+ const double cVol = sharedVolume(layout,parent,left,right);
+ child.Rows.resize(parent.Rows.size() - rowWords);
+ auto rowEnd = parent.Rows.cbegin() + static_cast<std::size_t>(right) * rowWords;
+ std::copy(parent.Rows.cbegin(),rowEnd,child.Rows.begin());
+ std::copy(rowEnd + rowWords,parent.Rows.cend(),child.Rows.begin() + static_cast<std::size_t>(right) * rowWords);
+ BitWord * lrow = &(child.Rows[static_cast<std::size_t>(left) * rowWords]);
+ const BitWord * rrow = &(parent.Rows[static_cast<std::size_t>(right) * rowWords]);
+ for(unsigned int w = 0; w < layout.TensWords; ++w) lrow[w] |= rrow[w];
+ for(unsigned int w = layout.TensWords; w < rowWords; ++w) lrow[w] ^= rrow[w]; //contracted legs disappear
+ child.Volumes = parent.Volumes;
+ child.Volumes[left] = parent.Volumes[left] * parent.Volumes[right] / (cVol * cVol);
+ child.Volumes.erase(child.Volumes.begin() + right);
+ child.Seq.reserve(parent.Seq.size() + 1);
+ child.Seq = parent.Seq;
+ child.Seq.emplace_back(std::pair<unsigned int, unsigned int>(left+1,right+1)); //r.h.s. tensors are numbered from 1
+ child.Cost = parent.Cost + contrCost(layout,parent.Volumes[left],parent.Volumes[right],cVol,parent.getNumGroups() > 2);
+ return;
+}
+
+/** Returns the canonical key of a configuration (the partition of the tensors into groups). **/
+std::string configKey(const ContrLayout & layout, const ContrConfig & config)
+{
+ const auto numGroups = config.getNumGroups();
+ std::string key(static_cast<std::size_t>(numGroups) * layout.TensWords * sizeof(BitWord),'\0');
+ char * dst = &key[0];
+ for(unsigned int i = 0; i < numGroups; ++i){
+  const BitWord * row = &(config.Rows[static_cast<std::size_t>(i) * layout.RowWords]);
+  for(unsigned int w = 0; w < layout.TensWords; ++w){
+   std::copy(reinterpret_cast<const char*>(&row[w]),reinterpret_cast<const char*>(&row[w]) + sizeof(BitWord),dst);
+   dst += sizeof(BitWord);
+  }
+ }
+ return key;
+}
+
+/** Converts a contraction tree given as a list of merges of tensor groups into
+    the contraction sequence numeration of TensorNetwork<T>::contractTensors().
+    Each tensor group is identified by its smallest original tensor id (0-based),
+    merges must be ordered such that both merged groups already exist. **/
+ContractionSequence sequenceFromMerges(unsigned int numTensors,
+                                       const std::vector<std::pair<unsigned int, unsigned int>> & merges)
+{
+ ContractionSequence contrSeq;
+ std::vector<unsigned int> groups(numTensors); //representatives of the existing groups (always sorted)
+ for(unsigned int i = 0; i < numTensors; ++i) groups[i] = i;
+ for(const auto & merge: merges){
+  const auto lrep = std::min(merge.first,merge.second);
+  const auto rrep = std::max(merge.first,merge.second);
+  const auto lpos = std::lower_bound(groups.cbegin(),groups.cend(),lrep) - groups.cbegin();
+  const auto rpos = std::lower_bound(groups.cbegin(),groups.cend(),rrep) - groups.cbegin();
+  assert(groups[lpos] == lrep && groups[rpos] == rrep && lpos < rpos);
+  contrSeq.emplace_back(std::pair<unsigned int, unsigned int>(lpos+1,rpos+1)); //r.h.s. tensors are numbered from 1
+  groups.erase(groups.begin() + rpos); //merged group keeps the smaller representative
+ }
+ return contrSeq;
+}
+
+/** Returns the wall clock time in seconds since an arbitrary moment. **/
+inline double wallTime()
+{
+ return std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Contraction tree used by the stochastic refiner: Leaves are the original tensors [0..N-1],
+    internal nodes [N..2N-2] are the pairwise contractions, the last node being the root. **/
+struct ContrTree{
+ struct Node{
+  int Left;            //left child (-1 for leaves)
+  int Right;           //right child (-1 for leaves)
+  int Parent;          //parent (-1 for the root)
+  unsigned int MinLeaf;//smallest original tensor id in the subtree
+  double Volume;       //volume of the (intermediate) tensor
+  double Cost;         //cost of the contraction (0 for leaves)
+ };
+
+ unsigned int NumLeaves;
+ unsigned int EdgeWords;
+ const ContrLayout * Layout;
+ std::vector<Node> Nodes;
+ std::vector<BitWord> Edges; //open legs of each node
+
+ BitWord * edges(int node) {return &(Edges[static_cast<std::size_t>(node) * EdgeWords]);}
+ const BitWord * edges(int node) const {return &(Edges[static_cast<std::size_t>(node) * EdgeWords]);}
+
+ /** Volume of the legs shared by two nodes. **/
+ double sharedVolume(int node1, int node2) const {
+  const BitWord * e1 = edges(node1); const BitWord * e2 = edges(node2);
+  double vol = 1.0;
+  for(unsigned int w = 0; w < EdgeWords; ++w){
+   BitWord bits = e1[w] & e2[w];
+   while(bits != 0){vol *= Layout->Extents[w * BITS_PER_WORD + __builtin_ctzll(bits)]; bits &= (bits - 1);}
+  }
+  return vol;
+ }
+
+ /** Recomputes the internal node from its children. **/
+ void updateNode(int node) {
+  auto & nd = Nodes[node];
+  const double cVol = sharedVolume(nd.Left,nd.Right);
+  BitWord * e = edges(node);
+  const BitWord * e1 = edges(nd.Left); const BitWord * e2 = edges(nd.Right);
+  for(unsigned int w = 0; w < EdgeWords; ++w) e[w] = e1[w] ^ e2[w];
+  nd.Volume = Nodes[nd.Left].Volume * Nodes[nd.Right].Volume / (cVol * cVol);
+  nd.Cost = contrCost(*Layout,Nodes[nd.Left].Volume,Nodes[nd.Right].Volume,cVol,node != static_cast<int>(Nodes.size()) - 1);
+  nd.MinLeaf = std::min(Nodes[nd.Left].MinLeaf,Nodes[nd.Right].MinLeaf);
+ }
+
+ /** Builds the contraction tree from a contraction sequence. **/
+ void build(const ContrLayout & layout, const ContractionGraph & graph, const ContractionSequence & contrSeq) {
+  ContrConfig config;
+  initConfig(layout,graph,config);
+  NumLeaves = layout.NumTensors; EdgeWords = layout.EdgeWords; Layout = &layout;
+  Nodes.assign(2 * NumLeaves - 1,Node{-1,-1,-1,0,1.0,0.0});
+  Edges.assign(static_cast<std::size_t>(2 * NumLeaves - 1) * EdgeWords,0);
+  std::vector<int> groups(NumLeaves);
+  for(unsigned int i = 0; i < NumLeaves; ++i){
+   groups[i] = i; Nodes[i].MinLeaf = i; Nodes[i].Volume = config.Volumes[i];
+   std::copy(&(config.Rows[static_cast<std::size_t>(i) * layout.RowWords + layout.TensWords]),
+             &(config.Rows[static_cast<std::size_t>(i) * layout.RowWords + layout.TensWords]) + EdgeWords,edges(i));
+  }
+  int next = NumLeaves;
+  for(const auto & contrPair: contrSeq){
+   auto lpos = std::min(contrPair.first,contrPair.second) - 1;
+   auto rpos = std::max(contrPair.first,contrPair.second) - 1;
+   assert(rpos < groups.size() && lpos < rpos);
+   Nodes[next].Left = groups[lpos]; Nodes[next].Right = groups[rpos];
+   Nodes[groups[lpos]].Parent = next; Nodes[groups[rpos]].Parent = next;
+   updateNode(next);
+   groups[lpos] = next; groups.erase(groups.begin() + rpos);
+   ++next;
+  }
+  assert(next == static_cast<int>(Nodes.size()));
+ }
+
+ /** Total cost of the contraction tree. **/
+ double totalCost() const {
+  double cost = 0.0;
+  for(unsigned int i = NumLeaves; i < Nodes.size(); ++i) cost += Nodes[i].Cost;
+  return cost;
+ }
+
+ /** Converts the contraction tree into a contraction sequence (post-order traversal). **/
+ ContractionSequence sequence() const {
+  std::vector<std::pair<unsigned int, unsigned int>> merges;
+  std::vector<std::pair<int,bool>> stack; //{node, children processed}
+  stack.emplace_back(std::make_pair(static_cast<int>(Nodes.size()) - 1,false));
+  while(!stack.empty()){
+   auto top = stack.back(); stack.pop_back();
+   const auto & nd = Nodes[top.first];
+   if(nd.Left < 0) continue; //leaf
+   if(top.second){
+    merges.emplace_back(std::make_pair(Nodes[nd.Left].MinLeaf,Nodes[nd.Right].MinLeaf));
+   }else{
+    stack.emplace_back(std::make_pair(top.first,true));
+    stack.emplace_back(std::make_pair(nd.Right,false));
+    stack.emplace_back(std::make_pair(nd.Left,false));
+   }
+  }
+  return sequenceFromMerges(NumLeaves,merges);
+ }
+};
+
+ContrCostModel defaultCostModel; //default cost model
+
+} //end unnamed namespace
+
+//ContrCostModel:
+
+ContrCostModel::ContrCostModel(const double flopRate,
+                               const double bandwidth,
+                               const std::size_t elemSize,
+                               const std::size_t memLimit):
+ FlopRate(flopRate), Bandwidth(bandwidth), ElemSize(elemSize), MemLimit(memLimit)
+{
+ assert(FlopRate >= 0.0 && Bandwidth >= 0.0 && ElemSize > 0);
+}
+
+/** Returns the machine balance (Flop per tensor element moved), 0 if unknown. **/
+double ContrCostModel::getMachineBalance() const
+{
+ if(FlopRate <= 0.0 || Bandwidth <= 0.0) return 0.0;
+ return FlopRate * static_cast<double>(ElemSize) / Bandwidth;
+}
+
+/** Returns the max volume of an intermediate tensor (infinity if unlimited). **/
+double ContrCostModel::getMaxVolume() const
+{
+ if(MemLimit == 0) return std::numeric_limits<double>::infinity();
+ return static_cast<double>(MemLimit / ElemSize);
+}
+
+/** Returns the (rescaled) Flop cost of a tensor contraction given the volumes of
+    both input tensors and the volume of their contracted legs (no memory limit check). **/
+double ContrCostModel::getCost(const double lVol,
+                               const double rVol,
+                               const double cVol) const
+{
+ double cost = lVol * rVol / cVol; //Flop count
+ const double balance = this->getMachineBalance();
+ if(balance > 0.0){
+  const double elems = lVol + rVol + lVol * rVol / (cVol * cVol); //tensor elements moved
+  if(cost < balance * elems) cost = balance * elems; //memory-bound tensor contraction
+ }
+ return cost;
+}
+
+/** Returns the default cost model (set up by exatensor::start() for the Host). **/
+const ContrCostModel & ContrCostModel::getDefault()
+{
+ return defaultCostModel;
+}
+
+/** Resets the default cost model. **/
+void ContrCostModel::setDefault(const ContrCostModel & costModel)
+{
+ defaultCostModel = costModel;
+ return;
+}
+
+//ContractionGraph:
+
+/** Constructs a contraction graph with a given number of r.h.s. tensors and no edges. **/
+ContractionGraph::ContractionGraph(const unsigned int numTensors):
+ TensEdges(numTensors+1)
+{
+}
+
+/** Returns the number of r.h.s. tensors (vertices, excluding the output tensor). **/
+unsigned int ContractionGraph::getNumTensors() const
+{
+ return static_cast<unsigned int>(TensEdges.size() - 1);
+}
+
+/** Returns the number of edges (legs). **/
+unsigned int ContractionGraph::getNumEdges() const
+{
+ return static_cast<unsigned int>(Edges.size());
+}
+
+/** Returns a specific edge. **/
+const ContractionGraph::Edge & ContractionGraph::getEdge(const unsigned int edgeId) const
+{
+ return Edges.at(edgeId);
+}
+
+/** Returns the ids of the edges incident to a specific tensor: [0..numTensors]. **/
+const std::vector<unsigned int> & ContractionGraph::getTensorEdges(const unsigned int tensId) const
+{
+ return TensEdges.at(tensId);
+}
+
+/** Returns the computational cost (Flop count) of a tensor contraction sequence
+    (each pair refers to the correspondingly reduced tensor network) under a given cost model. **/
+double ContractionGraph::getSequenceCost(const ContractionSequence & contrSeq,
+                                         const ContrCostModel & costModel) const
+{
+ ContrLayout layout(*this,costModel);
+ ContrConfig config, child;
+ initConfig(layout,*this,config);
+ for(const auto & contrPair: contrSeq){
+  unsigned int left = contrPair.first, right = contrPair.second;
+  if(left > right) std::swap(left,right);
+  assert(left >= 1 && right <= config.getNumGroups() && left != right);
+  contractGroups(layout,config,left-1,right-1,child);
+  std::swap(config,child);
+ }
+ return config.Cost;
+}
+
+/** Returns the peak total volume of simultaneously existing intermediate tensors
+    of a tensor contraction sequence (intermediates are released once consumed). **/
+double ContractionGraph::getSequencePeakVolume(const ContractionSequence & contrSeq,
+                                               double * maxVolume) const
+{
+ ContrLayout layout(*this,ContrCostModel());
+ ContrConfig config, child;
+ initConfig(layout,*this,config);
+ std::vector<bool> interm(config.getNumGroups(),false); //whether a group is an intermediate tensor
+ double liveVol = 0.0, peakVol = 0.0, maxVol = 0.0;
+ for(const auto & contrPair: contrSeq){
+  unsigned int left = contrPair.first, right = contrPair.second;
+  if(left > right) std::swap(left,right);
+  assert(left >= 1 && right <= config.getNumGroups() && left != right);
+  --left; --right;
+  const bool last = (config.getNumGroups() == 2); //the last tensor contraction produces the output tensor
+  contractGroups(layout,config,left,right,child);
+  const double vol = last ? 0.0 : child.Volumes[left];
+  peakVol = std::max(peakVol,liveVol + vol); //both input tensors are still alive
+  maxVol = std::max(maxVol,vol);
+  if(interm[left]) liveVol -= config.Volumes[left];
+  if(interm[right]) liveVol -= config.Volumes[right];
+  liveVol += vol; interm[left] = !last;
+  interm.erase(interm.begin() + right);
+  std::swap(config,child);
+ }
+ if(maxVolume != nullptr) *maxVolume = maxVol;
+ return peakVol;
+}
+
+/** Determines a set of contracted edges (connecting two r.h.s. tensors) to slice, such that
+    the intermediate tensors of each slice of a given tensor contraction sequence fit into
+    the memory limits, while keeping the total Flop count over all slices low. The memory
+    overload is the largest ratio of the peak total volume or the largest intermediate volume
+    to its respective limit (the slicing is done once the overload drops to 1 or below). **/
+double ContractionGraph::determineSlicing(const ContractionSequence & contrSeq,
+                                          const double maxVolume,
+                                          const double maxTensVolume,
+                                          std::vector<unsigned int> & slicedEdges) const
+{
+ auto overload = [&](const ContractionGraph & graph){
+  double maxVol = 0.0;
+  const double peakVol = graph.getSequencePeakVolume(contrSeq,&maxVol);
+  return std::max(peakVol / maxVolume, maxVol / maxTensVolume);
+ };
+ slicedEdges.clear();
+ ContractionGraph sliced(*this);
+ double numSlices = 1.0;
+ double load = overload(sliced);
+ double totalCost = sliced.getSequenceCost(contrSeq);
+ while(load > 1.0){
+  //Find the edge with the lowest Flop overhead per memory overload reduction:
+  bool found = false;
+  unsigned int bestEdge = 0;
+  double bestScore = 0.0, bestLoad = 0.0, bestCost = 0.0;
+  for(unsigned int edgeId = 0; edgeId < sliced.getNumEdges(); ++edgeId){
+   const auto edge = sliced.getEdge(edgeId);
+   if(edge.TensId2 == 0 || edge.TensId1 == edge.TensId2 || edge.Extent < 2) continue; //not a contracted edge
+   sliced.resetEdgeExtent(edgeId,1);
+   const double newLoad = overload(sliced);
+   const double cost = numSlices * static_cast<double>(edge.Extent) * sliced.getSequenceCost(contrSeq);
+   sliced.resetEdgeExtent(edgeId,edge.Extent);
+   if(newLoad >= load) continue; //no memory reduction
+   const double score = std::log(cost / totalCost) / std::log(load / newLoad);
+   if(!found || score < bestScore || (score == bestScore && newLoad < bestLoad)){
+    found = true; bestEdge = edgeId; bestScore = score; bestLoad = newLoad; bestCost = cost;
+   }
+  }
+  if(!found) return std::numeric_limits<double>::infinity(); //memory limits cannot be met
+  numSlices *= static_cast<double>(sliced.getEdge(bestEdge).Extent);
+  sliced.resetEdgeExtent(bestEdge,1);
+  slicedEdges.emplace_back(bestEdge);
+  load = bestLoad; totalCost = bestCost;
+ }
+ return totalCost;
+}
+
+/** Prints. **/
+void ContractionGraph::printIt() const
+{
+ std::cout << "ContractionGraph{" << std::endl;
+ std::cout << "Number of input tensors = " << this->getNumTensors() << std::endl;
+ for(unsigned int i = 0; i < Edges.size(); ++i){
+  std::cout << " Edge " << i << ": {" << Edges[i].TensId1 << "," << Edges[i].TensId2 << "}: Extent = " << Edges[i].Extent << std::endl;
+ }
+ std::cout << "}" << std::endl;
+ return;
+}
+
+/** Appends a new edge connecting two tensors and returns its id. **/
+unsigned int ContractionGraph::appendEdge(const unsigned int tensId1,
+                                          const unsigned int tensId2,
+                                          const std::size_t extent)
+{
+ assert(tensId1 > 0 && tensId1 < TensEdges.size() && tensId2 < TensEdges.size());
+ const auto edgeId = static_cast<unsigned int>(Edges.size());
+ Edges.emplace_back(Edge{tensId1,tensId2,extent});
+ TensEdges[tensId1].emplace_back(edgeId);
+ TensEdges[tensId2].emplace_back(edgeId);
+ return edgeId;
+}
+
+/** Resets the extent of an existing edge. **/
+void ContractionGraph::resetEdgeExtent(const unsigned int edgeId,
+                                       const std::size_t extent)
+{
+ assert(extent > 0);
+ Edges.at(edgeId).Extent = extent;
+ return;
+}
+
+//ContrSeqOptimizer:
+
+/** Sets the cost model (the pure Flop count without memory limit by default). **/
+void ContrSeqOptimizer::setCostModel(const ContrCostModel & costModel)
+{
+ CostModel = costModel;
+ return;
+}
+
+/** Returns the cost model. **/
+const ContrCostModel & ContrSeqOptimizer::getCostModel() const
+{
+ return CostModel;
+}
+
+//ContrSeqOptimizerBeam:
+
+/** Constructs a beam search optimizer with a given beam width. **/
+ContrSeqOptimizerBeam::ContrSeqOptimizerBeam(const unsigned int numWalkers):
+ NumWalkers(numWalkers)
+{
+ assert(NumWalkers > 0);
+}
+
+/** Determines a pseudo-optimal tensor contraction sequence for a given
+    contraction graph and returns its computational cost. **/
+double ContrSeqOptimizerBeam::determineContrSequence(const ContractionGraph & graph,
+                                                     ContractionSequence & contrSeq)
+{
+ contrSeq.clear(); //initial guess is not used
+ const auto numTensors = graph.getNumTensors();
+ if(numTensors < 2) return 0.0; //nothing to contract
+ const auto numContractions = numTensors - 1;
+
+ ContrLayout layout(graph,CostModel);
+ std::vector<ContrConfig> beam(1);
+ initConfig(layout,graph,beam[0]); //initial configuration
+
+ std::vector<ContrCandidate> candidates;
+ std::unordered_set<std::string> visited;
+ for(unsigned int pass = 0; pass < numContractions; ++pass){
+  candidates.clear();
+  const int numConfigs = static_cast<int>(beam.size());
+  //Expand the beam (each thread keeps its own best candidates):
+#pragma omp parallel shared(beam,candidates)
+  {
+   std::priority_queue<ContrCandidate> best; //max-heap: the worst kept candidate on top
+#pragma omp for schedule(dynamic)
+   for(int k = 0; k < numConfigs; ++k){
+    const auto & config = beam[k];
+    const auto numGroups = config.getNumGroups();
+    for(unsigned int i = 0; i < numGroups; ++i){
+     for(unsigned int j = i + 1; j < numGroups; ++j){
+      ContrCandidate cand{config.Cost + pairCost(layout,config,i,j),static_cast<unsigned int>(k),i,j};
+      if(best.size() < NumWalkers){
+       best.push(cand);
+      }else if(cand < best.top()){
+       best.pop(); best.push(cand);
+      }
+     }
+    }
+   }
+#pragma omp critical
+   {
+    while(!best.empty()){candidates.emplace_back(best.top()); best.pop();}
+   }
+  }
+  std::sort(candidates.begin(),candidates.end());
+  //Form the next beam from the best distinct configurations (equivalent configurations are merged):
+  std::vector<ContrConfig> nextBeam;
+  nextBeam.reserve(std::min(static_cast<std::size_t>(NumWalkers),candidates.size()));
+  visited.clear();
+  ContrConfig child;
+  for(const auto & cand: candidates){
+   if(nextBeam.size() >= NumWalkers) break;
+   contractGroups(layout,beam[cand.Parent],cand.Left,cand.Right,child);
+   if(visited.emplace(configKey(layout,child)).second) nextBeam.emplace_back(std::move(child));
+  }
+  beam = std::move(nextBeam);
+ }
+ contrSeq = beam[0].Seq;
+ return beam[0].Cost;
+}
+
+//ContrSeqOptimizerGreedy:
+
+/** Determines a greedy tensor contraction sequence for a given
+    contraction graph and returns its computational cost. **/
+double ContrSeqOptimizerGreedy::determineContrSequence(const ContractionGraph & graph,
+                                                       ContractionSequence & contrSeq)
+{
+ contrSeq.clear(); //initial guess is not used
+ const auto numTensors = graph.getNumTensors();
+ if(numTensors < 2) return 0.0; //nothing to contract
+
+ ContrLayout layout(graph,CostModel);
+ ContrConfig config, child;
+ initConfig(layout,graph,config);
+ while(config.getNumGroups() > 1){
+  const auto numGroups = config.getNumGroups();
+  bool found = false;
+  unsigned int left = 0, right = 1;
+  double bestScore = 0.0, bestCost = 0.0;
+  for(unsigned int i = 0; i < numGroups; ++i){
+   for(unsigned int j = i + 1; j < numGroups; ++j){
+    if(!sharesLegs(layout,config,i,j)) continue;
+    const double cVol = sharedVolume(layout,config,i,j);
+    const double vol = config.Volumes[i] * config.Volumes[j] / (cVol * cVol);
+    if(numGroups > 2 && vol > layout.MaxVolume) continue; //intermediate tensor does not fit into the memory limit
+    const double score = vol - config.Volumes[i] - config.Volumes[j]; //change in the total tensor volume
+    const double cost = layout.CostModel.getCost(config.Volumes[i],config.Volumes[j],cVol);
+    if(!found || score < bestScore || (score == bestScore && cost < bestCost)){
+     found = true; bestScore = score; bestCost = cost; left = i; right = j;
+    }
+   }
+  }
+  if(!found){ //disconnected tensor network (or no feasible contraction): outer product of the two smallest tensors
+   std::vector<unsigned int> order(numGroups);
+   for(unsigned int i = 0; i < numGroups; ++i) order[i] = i;
+   std::partial_sort(order.begin(),order.begin()+2,order.end(),
+                     [&config](unsigned int a, unsigned int b){return config.Volumes[a] < config.Volumes[b];});
+   left = std::min(order[0],order[1]); right = std::max(order[0],order[1]);
+  }
+  contractGroups(layout,config,left,right,child);
+  std::swap(config,child);
+ }
+ contrSeq = config.Seq;
+ return config.Cost;
+}
+
+//ContrSeqOptimizerDP:
+
+/** Constructs an exact optimizer with a given limit on the number of tensors. **/
+ContrSeqOptimizerDP::ContrSeqOptimizerDP(const unsigned int maxTensors):
+ MaxTensors(maxTensors)
+{
+ assert(MaxTensors <= 24); //memory requirements grow as 2^N
+}
+
+/** Determines the Flop-optimal tensor contraction sequence for a given
+    contraction graph and returns its computational cost. **/
+double ContrSeqOptimizerDP::determineContrSequence(const ContractionGraph & graph,
+                                                   ContractionSequence & contrSeq)
+{
+ const auto numTensors = graph.getNumTensors();
+ if(numTensors > MaxTensors){ //too large for the exact treatment
+  ContrSeqOptimizerGreedy greedy;
+  greedy.setCostModel(CostModel);
+  return greedy.determineContrSequence(graph,contrSeq);
+ }
+ contrSeq.clear(); //initial guess is not used
+ if(numTensors < 2) return 0.0; //nothing to contract
+
+ using SubSet = std::uint32_t;
+ const double INF = std::numeric_limits<double>::infinity();
+ const SubSet numSubsets = (SubSet{1} << numTensors);
+ //Per-tensor data (tensors are numbered from 0 here):
+ ContrLayout layout(graph,CostModel);
+ ContrConfig config;
+ initConfig(layout,graph,config);
+ std::vector<SubSet> nbr1(numTensors,0); //adjacent tensors
+ for(unsigned int t = 0; t < numTensors; ++t){
+  for(const auto edgeId: graph.getTensorEdges(t+1)){
+   const auto & edge = graph.getEdge(edgeId);
+   const auto other = (edge.TensId1 == t+1) ? edge.TensId2 : edge.TensId1;
+   if(other != 0 && other != t+1) nbr1[t] |= (SubSet{1} << (other-1));
+  }
+ }
+ //Dynamic programming over subsets (a proper subset is always numerically smaller):
+ std::vector<double> sqrtVol(numSubsets,1.0); //square root of the volume of the intermediate tensor
+ std::vector<SubSet> nbr(numSubsets,0);       //tensors adjacent to the subset
+ std::vector<double> best(numSubsets,INF);    //optimal cost of contracting the subset (INF: disconnected or infeasible subset)
+ std::vector<SubSet> split(numSubsets,0);     //optimal split of the subset
+ for(SubSet s = 1; s < numSubsets; ++s){
+  const SubSet low = s & (~s + 1);
+  const unsigned int t = __builtin_ctz(s);
+  const SubSet rest = s ^ low;
+  if(rest == 0){
+   sqrtVol[s] = std::sqrt(config.Volumes[t]); nbr[s] = nbr1[t]; best[s] = 0.0;
+   continue;
+  }
+  nbr[s] = nbr[rest] | nbr1[t];
+  double sh = 1.0; //volume of the legs shared by tensor t and the rest
+  for(const auto edgeId: graph.getTensorEdges(t+1)){
+   const auto & edge = graph.getEdge(edgeId);
+   const auto other = (edge.TensId1 == t+1) ? edge.TensId2 : edge.TensId1;
+   if(other != 0 && other != t+1 && ((rest >> (other-1)) & 1)) sh *= static_cast<double>(edge.Extent);
+  }
+  sqrtVol[s] = sqrtVol[rest] * sqrtVol[low] / sh;
+  //Check connectivity of the subset:
+  SubSet reach = low;
+  while(true){
+   const SubSet grown = reach | (nbr[reach] & s);
+   if(grown == reach) break;
+   reach = grown;
+  }
+  if(reach != s) continue; //disconnected subset
+  //Find the optimal split into two connected adjacent subsets:
+  for(SubSet a = (s - 1) & s; a != 0; a = (a - 1) & s){
+   if((a & low) == 0) continue; //each split is considered once
+   const SubSet b = s ^ a;
+   if(best[a] == INF || best[b] == INF || (nbr[a] & b) == 0) continue;
+   const double cost = best[a] + best[b] +
+    contrCost(layout,sqrtVol[a]*sqrtVol[a],sqrtVol[b]*sqrtVol[b],sqrtVol[a]*sqrtVol[b]/sqrtVol[s],s != numSubsets - 1);
+   if(cost < best[s]){best[s] = cost; split[s] = a;}
+  }
+ }
+ //Find connected components and join them in the order of increasing volume:
+ std::vector<SubSet> components;
+ SubSet covered = 0;
+ for(unsigned int t = 0; t < numTensors; ++t){
+  if((covered >> t) & 1) continue;
+  SubSet reach = (SubSet{1} << t);
+  while(true){
+   SubSet grown = reach;
+   for(unsigned int u = 0; u < numTensors; ++u) if((reach >> u) & 1) grown |= nbr1[u];
+   if(grown == reach) break;
+   reach = grown;
+  }
+  components.emplace_back(reach); covered |= reach;
+ }
+ std::sort(components.begin(),components.end(),[&sqrtVol](SubSet a, SubSet b){return sqrtVol[a] < sqrtVol[b];});
+ for(const auto component: components){
+  if(best[component] == INF){ //no feasible contraction tree within the memory limit
+   ContrSeqOptimizerGreedy greedy;
+   greedy.setCostModel(CostModel);
+   return greedy.determineContrSequence(graph,contrSeq);
+  }
+ }
+ //Unfold the optimal contraction trees into merges (children before parents):
+ std::vector<std::pair<unsigned int, unsigned int>> merges;
+ std::vector<std::pair<SubSet,bool>> stack; //{subset, children processed}
+ for(const auto component: components){
+  stack.emplace_back(std::make_pair(component,false));
+  while(!stack.empty()){
+   auto top = stack.back(); stack.pop_back();
+   const SubSet a = split[top.first];
+   if(a == 0) continue; //single tensor
+   const SubSet b = top.first ^ a;
+   if(top.second){
+    merges.emplace_back(std::make_pair(__builtin_ctz(a),__builtin_ctz(b)));
+   }else{
+    stack.emplace_back(std::make_pair(top.first,true));
+    stack.emplace_back(std::make_pair(b,false));
+    stack.emplace_back(std::make_pair(a,false));
+   }
+  }
+ }
+ for(unsigned int i = 1; i < components.size(); ++i){
+  merges.emplace_back(std::make_pair(__builtin_ctz(components[0]),__builtin_ctz(components[i])));
+ }
+ contrSeq = sequenceFromMerges(numTensors,merges);
+ return graph.getSequenceCost(contrSeq,CostModel);
+}
+
+//ContrSeqOptimizerAnneal:
+
+/** Constructs a simulated annealing refiner. **/
+ContrSeqOptimizerAnneal::ContrSeqOptimizerAnneal(const unsigned int numIterations,
+                                                 const double timeBudget,
+                                                 const unsigned int seed):
+ NumIterations(numIterations), TimeBudget(timeBudget), Seed(seed)
+{
+}
+
+/** Refines a given tensor contraction sequence (or the greedy one if none is given)
+    and returns its computational cost. **/
+double ContrSeqOptimizerAnneal::determineContrSequence(const ContractionGraph & graph,
+                                                       ContractionSequence & contrSeq)
+{
+ const double TEMP_BEG = 1.0;  //initial temperature (natural logarithm of the cost ratio)
+ const double TEMP_END = 1e-3; //final temperature
+ const unsigned int TIME_CHECK_PERIOD = 1024; //period of checking the time budget
+
+ const double timeBeg = wallTime();
+ const auto numTensors = graph.getNumTensors();
+ if(numTensors < 2){contrSeq.clear(); return 0.0;} //nothing to contract
+ if(contrSeq.size() != numTensors - 1){ //no initial guess: start from the greedy contraction sequence
+  ContrSeqOptimizerGreedy greedy;
+  greedy.setCostModel(CostModel);
+  greedy.determineContrSequence(graph,contrSeq);
+ }
+ if(numTensors < 3) return graph.getSequenceCost(contrSeq,CostModel); //no alternative contraction trees
+
+ ContrLayout layout(graph,CostModel);
+ ContrTree tree;
+ tree.build(layout,graph,contrSeq);
+ double totalCost = tree.totalCost();
+ if(totalCost == std::numeric_limits<double>::infinity()) return totalCost; //infeasible initial contraction tree
+ double bestCost = totalCost;
+ ContractionSequence bestSeq = contrSeq;
+
+ std::mt19937 generator(Seed);
+ std::uniform_real_distribution<double> uniform(0.0,1.0);
+ std::uniform_int_distribution<int> nonRoot(numTensors,2*numTensors-3); //internal nodes except the root
+ const double coolRate = std::pow(TEMP_END/TEMP_BEG,1.0/static_cast<double>(std::max(NumIterations,1u)));
+ double temperature = TEMP_BEG;
+ for(unsigned int iter = 0; iter < NumIterations; ++iter, temperature *= coolRate){
+  if(TimeBudget > 0.0 && (iter % TIME_CHECK_PERIOD) == 0){
+   if(wallTime() - timeBeg > TimeBudget) break;
+  }
+  //Rotation: P = (X,Y), X = (K,M) --> P = (M,X'), X' = (K,Y):
+  const int x = nonRoot(generator);
+  const int p = tree.Nodes[x].Parent;
+  const int y = (tree.Nodes[p].Left == x) ? tree.Nodes[p].Right : tree.Nodes[p].Left;
+  const bool keepLeft = (uniform(generator) < 0.5);
+  const int k = keepLeft ? tree.Nodes[x].Left : tree.Nodes[x].Right;
+  const int m = keepLeft ? tree.Nodes[x].Right : tree.Nodes[x].Left;
+  const auto & nk = tree.Nodes[k]; const auto & nm = tree.Nodes[m]; const auto & ny = tree.Nodes[y];
+  const double kyShared = tree.sharedVolume(k,y);
+  const double xVol = nk.Volume * ny.Volume / (kyShared * kyShared);
+  const double xCost = contrCost(layout,nk.Volume,ny.Volume,kyShared,true);
+  const double mxShared = std::sqrt(nm.Volume * xVol / tree.Nodes[p].Volume); //legs shared by M and X'
+  const double pCost = contrCost(layout,nm.Volume,xVol,mxShared,p != static_cast<int>(tree.Nodes.size()) - 1);
+  const double newCost = totalCost - tree.Nodes[x].Cost - tree.Nodes[p].Cost + xCost + pCost;
+  if(newCost <= totalCost || uniform(generator) < std::exp(-std::log(newCost/totalCost)/temperature)){
+   auto & np = tree.Nodes[p]; auto & nx = tree.Nodes[x];
+   nx.Left = k; nx.Right = y; tree.Nodes[y].Parent = x;
+   np.Left = m; np.Right = x; tree.Nodes[m].Parent = p;
+   tree.updateNode(x); tree.updateNode(p);
+   totalCost = tree.totalCost(); //avoids accumulation of rounding errors
+   if(totalCost < bestCost){bestCost = totalCost; bestSeq = tree.sequence();}
+  }
+ }
+ contrSeq = bestSeq;
+ return graph.getSequenceCost(contrSeq,CostModel);
+}
+
+//ContrSeqOptimizerAuto:
+
+/** Constructs a time-budgeted optimizer. **/
+ContrSeqOptimizerAuto::ContrSeqOptimizerAuto(const double timeBudget):
+ TimeBudget(timeBudget)
+{
+}
+
+/** Determines a pseudo-optimal tensor contraction sequence within the time budget
+    and returns its computational cost. **/
+double ContrSeqOptimizerAuto::determineContrSequence(const ContractionGraph & graph,
+                                                     ContractionSequence & contrSeq)
+{
+ const unsigned int PROBE_WALKERS = 16;    //beam width of the probing beam search
+ const unsigned int MAX_WALKERS = 1024;    //max beam width
+ const double DP_SPLIT_TIME = 5e-9;        //estimated time of a single subset split in the exact optimizer (sec)
+
+ const double timeBeg = wallTime();
+ const auto numTensors = graph.getNumTensors();
+ //The exact optimizer considers up to 3^N subset splits, thus it is only used if they fit into the time budget:
+ const double dpTime = std::pow(3.0,static_cast<double>(numTensors)) * DP_SPLIT_TIME;
+ if(numTensors <= ContrSeqOptimizerDP::MaxTensorsDefault && dpTime <= TimeBudget){
+  ContrSeqOptimizerDP exact;
+  exact.setCostModel(CostModel);
+  return exact.determineContrSequence(graph,contrSeq);
+ }
+ //Greedy contraction sequence:
+ ContrSeqOptimizerGreedy greedy;
+ greedy.setCostModel(CostModel);
+ double bestCost = greedy.determineContrSequence(graph,contrSeq);
+ //Beam search with the beam width affordable within a half of the remaining time budget:
+ double timeLeft = TimeBudget - (wallTime() - timeBeg);
+ if(timeLeft > 0.0){
+  const double timeProbe = wallTime();
+  ContractionSequence seq;
+  ContrSeqOptimizerBeam probe(PROBE_WALKERS);
+  probe.setCostModel(CostModel);
+  double cost = probe.determineContrSequence(graph,seq);
+  if(cost < bestCost){bestCost = cost; contrSeq = seq;}
+  const double probeTime = std::max(wallTime() - timeProbe,1e-6);
+  timeLeft = TimeBudget - (wallTime() - timeBeg);
+  const double walkers = static_cast<double>(PROBE_WALKERS) * (0.5 * timeLeft / probeTime);
+  if(walkers >= static_cast<double>(2 * PROBE_WALKERS)){
+   ContrSeqOptimizerBeam beam(static_cast<unsigned int>(std::min(walkers,static_cast<double>(MAX_WALKERS))));
+   beam.setCostModel(CostModel);
+   seq.clear();
+   cost = beam.determineContrSequence(graph,seq);
+   if(cost < bestCost){bestCost = cost; contrSeq = seq;}
+  }
+ }
+ //Stochastic refinement during the rest of the time budget:
+ timeLeft = TimeBudget - (wallTime() - timeBeg);
+ if(timeLeft > 0.0){
+  ContrSeqOptimizerAnneal refiner(std::numeric_limits<unsigned int>::max(),timeLeft);
+  refiner.setCostModel(CostModel);
+  bestCost = refiner.determineContrSequence(graph,contrSeq);
+ }
+ return bestCost;
+}
+
+} //end namespace exatensor
@@ -0,0 +1,280 @@
+/** C++ adapters for ExaTENSOR: Tensor contraction sequence optimization
+
+!AUTHOR: Dmitry I. Lyakh (Liakh): quant4me@gmail.com
+!REVISION: 2020/07/14
+
+!Copyright (C) 2014-2020 Dmitry I. Lyakh (Liakh)
+!Copyright (C) 2014-2020 Oak Ridge National Laboratory (UT-Battelle)
+
+!This file is part of ExaTensor.
+
+!ExaTensor is free software: you can redistribute it and/or modify
+!it under the terms of the GNU Lesser General Public License as published
+!by the Free Software Foundation, either version 3 of the License, or
+!(at your option) any later version.
+
+!ExaTensor is distributed in the hope that it will be useful,
+!but WITHOUT ANY WARRANTY; without even the implied warranty of
+!MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+!GNU Lesser General Public License for more details.
+
+!You should have received a copy of the GNU Lesser General Public License
+!along with ExaTensor. If not, see <http://www.gnu.org/licenses/>.
+
+**/
+
+#ifndef EXA_CONTR_SEQ_OPTIMIZER_H_
+#define EXA_CONTR_SEQ_OPTIMIZER_H_
+
+#include <cstddef>
+#include <assert.h>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "type_deduct.hpp"
+
+namespace exatensor {
+
+//Types:
+using ContractionSequence = std::vector<std::pair<unsigned int, unsigned int>>;
+
+/** Cost model of a pairwise tensor contraction:
+ The Flop count of a memory-bound tensor contraction (its arithmetic intensity
+ is below the machine balance derived from the sustained Flop rate and memory
+ bandwidth) is rescaled to the Flop count the machine could have executed while
+ moving the data. Intermediate tensors exceeding the memory limit render the
+ tensor contraction infeasible (infinite cost). The default-constructed cost
+ model reduces to the pure Flop count without any memory limit. **/
+struct ContrCostModel{
+ double FlopRate;      //sustained Flop rate (Flop/s): 0 means unknown
+ double Bandwidth;     //sustained memory bandwidth (bytes/s): 0 means unknown
+ std::size_t ElemSize; //size of a tensor element (bytes)
+ std::size_t MemLimit; //max size of an intermediate tensor (bytes): 0 means unlimited
+
+ ContrCostModel(const double flopRate = 0.0,     //in: sustained Flop rate (Flop/s)
+                const double bandwidth = 0.0,    //in: sustained memory bandwidth (bytes/s)
+                const std::size_t elemSize = 8,  //in: size of a tensor element (bytes)
+                const std::size_t memLimit = 0); //in: max size of an intermediate tensor (bytes)
+
+ /** Returns the machine balance (Flop per tensor element moved), 0 if unknown. **/
+ double getMachineBalance() const;
+ /** Returns the max volume of an intermediate tensor (infinity if unlimited). **/
+ double getMaxVolume() const;
+ /** Returns the (rescaled) Flop cost of a tensor contraction given the volumes of
+     both input tensors and the volume of their contracted legs (no memory limit check). **/
+ double getCost(const double lVol,        //in: volume of the left tensor
+                const double rVol,        //in: volume of the right tensor
+                const double cVol) const; //in: volume of the contracted legs
+
+ /** Returns the default cost model (set up by exatensor::start() for the Host). **/
+ static const ContrCostModel & getDefault();
+ /** Resets the default cost model. **/
+ static void setDefault(const ContrCostModel & costModel);
+};
+
+/** Compact topology of a tensor network (contraction graph):
+ Vertices are the r.h.s. tensors numerated from 1 (vertex 0 is the
+ output tensor), edges are the tensor legs connecting two r.h.s. tensors
+ or a r.h.s. tensor with the output tensor (open edges). The contraction
+ graph carries no tensor bodies, thus it is cheap to copy and to analyze. **/
+class ContractionGraph{
+
+public:
+
+ /** Edge of the contraction graph (tensor leg). **/
+ struct Edge{
+  unsigned int TensId1; //1st connected tensor id (r.h.s. tensor, >0)
+  unsigned int TensId2; //2nd connected tensor id (0 for an open leg connected to the output tensor)
+  std::size_t Extent;   //leg extent (dimension extent)
+ };
+
+//Life cycle:
+ /** Constructs a contraction graph with a given number of r.h.s. tensors and no edges. **/
+ explicit ContractionGraph(const unsigned int numTensors = 0); //in: number of r.h.s. tensors
+
+//Accessors:
+ /** Returns the number of r.h.s. tensors (vertices, excluding the output tensor). **/
+ unsigned int getNumTensors() const;
+ /** Returns the number of edges (legs). **/
+ unsigned int getNumEdges() const;
+ /** Returns a specific edge. **/
+ const Edge & getEdge(const unsigned int edgeId) const;
+ /** Returns the ids of the edges incident to a specific tensor: [0..numTensors]. **/
+ const std::vector<unsigned int> & getTensorEdges(const unsigned int tensId) const;
+ /** Returns the computational cost (Flop count) of a tensor contraction sequence
+     (each pair refers to the correspondingly reduced tensor network) under a given cost model. **/
+ double getSequenceCost(const ContractionSequence & contrSeq,                      //in: contraction sequence
+                        const ContrCostModel & costModel = ContrCostModel()) const; //in: cost model
+ /** Returns the peak total volume of simultaneously existing intermediate tensors
+     of a tensor contraction sequence (intermediates are released once consumed). **/
+ double getSequencePeakVolume(const ContractionSequence & contrSeq, //in: contraction sequence
+                              double * maxVolume = nullptr) const;  //out: volume of the largest intermediate tensor
+ /** Determines a set of contracted edges (connecting two r.h.s. tensors) to slice, such that
+     the intermediate tensors of each slice of a given tensor contraction sequence fit into
+     the memory limits, while keeping the total Flop count over all slices low. The edges are
+     selected greedily, each time the one with the lowest Flop overhead per memory overload reduction.
+     Returns the total Flop count over all slices (infinity if the memory limits cannot be met). **/
+ double determineSlicing(const ContractionSequence & contrSeq,           //in: contraction sequence
+                         const double maxVolume,                         //in: max peak total volume of intermediate tensors
+                         const double maxTensVolume,                     //in: max volume of a single intermediate tensor
+                         std::vector<unsigned int> & slicedEdges) const; //out: sliced edges
+ /** Prints. **/
+ void printIt() const;
+
+//Mutators:
+ /** Appends a new edge connecting two tensors and returns its id. **/
+ unsigned int appendEdge(const unsigned int tensId1, //in: 1st connected tensor id (>0)
+                         const unsigned int tensId2, //in: 2nd connected tensor id (0 for an open leg)
+                         const std::size_t extent);  //in: leg extent
+ /** Resets the extent of an existing edge. **/
+ void resetEdgeExtent(const unsigned int edgeId,  //in: edge id
+                      const std::size_t extent); //in: new leg extent
+
+private:
+
+ std::vector<Edge> Edges;                           //edges (legs)
+ std::vector<std::vector<unsigned int>> TensEdges;  //edges incident to each tensor: [0;1..numTensors]
+
+};
+
+/** Abstract tensor contraction sequence optimizer (strategy interface):
+ A concrete optimizer determines a pseudo-optimal tensor contraction sequence
+ for a given contraction graph. On entrance, the contraction sequence is either
+ empty or contains an initial guess which refining optimizers will use as their
+ starting point (other optimizers discard it). The numeration of the tensors in
+ the produced contraction sequence follows the convention of
+ TensorNetwork<T>::contractTensors(). **/
+class ContrSeqOptimizer{
+
+public:
+
+ virtual ~ContrSeqOptimizer() = default;
+
+ /** Determines a pseudo-optimal tensor contraction sequence for a given
+     contraction graph and returns its computational cost under the cost
+     model of the optimizer (infinity if no feasible sequence was found). **/
+ virtual double determineContrSequence(const ContractionGraph & graph,     //in: contraction graph of the tensor network
+                                       ContractionSequence & contrSeq) = 0; //inout: contraction sequence (empty or initial guess on entrance)
+
+ /** Sets the cost model (the pure Flop count without memory limit by default). **/
+ void setCostModel(const ContrCostModel & costModel);
+ /** Returns the cost model. **/
+ const ContrCostModel & getCostModel() const;
+
+protected:
+
+ ContrCostModel CostModel; //cost model of tensor contractions
+
+};
+
+/** Beam search optimizer of the tensor contraction sequence:
+ Each candidate configuration is represented compactly as an ordered list
+ of tensor groups (bitset of merged tensors plus bitset of open legs with
+ the cached tensor volume). Equivalent configurations reached via different
+ paths are merged, and the beam is expanded in parallel across OpenMP threads. **/
+class ContrSeqOptimizerBeam: public ContrSeqOptimizer{
+
+public:
+
+ /** Constructs a beam search optimizer with a given beam width. **/
+ explicit ContrSeqOptimizerBeam(const unsigned int numWalkers); //in: beam width (number of walkers)
+
+ double determineContrSequence(const ContractionGraph & graph,
+                               ContractionSequence & contrSeq) override;
+
+private:
+
+ unsigned int NumWalkers; //beam width
+
+};
+
+/** Greedy optimizer of the tensor contraction sequence, O(N^3):
+ At each step contracts the pair of connected tensors that reduces the total
+ tensor volume the most among those producing intermediate tensors within
+ the memory limit (ties are resolved by the cost). Intended for
+ very large tensor networks where other optimizers are too expensive. **/
+class ContrSeqOptimizerGreedy: public ContrSeqOptimizer{
+
+public:
+
+ double determineContrSequence(const ContractionGraph & graph,
+                               ContractionSequence & contrSeq) override;
+
+};
+
+/** Exact optimizer of the tensor contraction sequence (dynamic programming over subsets):
+ Determines the Flop-optimal contraction tree over connected subsets of tensors,
+ connected components being joined at the end in the order of increasing volume.
+ The cost is exponential in the number of tensors, thus tensor networks with
+ more than "maxTensors" tensors are delegated to the greedy optimizer. **/
+class ContrSeqOptimizerDP: public ContrSeqOptimizer{
+
+public:
+
+ /** Constructs an exact optimizer with a given limit on the number of tensors. **/
+ explicit ContrSeqOptimizerDP(const unsigned int maxTensors = MaxTensorsDefault); //in: max number of tensors handled exactly (<= 24)
+
+ double determineContrSequence(const ContractionGraph & graph,
+                               ContractionSequence & contrSeq) override;
+
+ static const unsigned int MaxTensorsDefault = 20; //default max number of tensors handled exactly
+
+private:
+
+ unsigned int MaxTensors; //max number of tensors handled exactly
+
+};
+
+/** Stochastic refiner of the tensor contraction sequence (simulated annealing):
+ Improves a given contraction sequence (or the greedy one if none is given)
+ by random local rotations of the contraction tree accepted according to the
+ Metropolis criterion on the logarithm of the total Flop cost. The best contraction
+ tree found is returned after the given number of iterations or time budget. **/
+class ContrSeqOptimizerAnneal: public ContrSeqOptimizer{
+
+public:
+
+ /** Constructs a simulated annealing refiner. **/
+ explicit ContrSeqOptimizerAnneal(const unsigned int numIterations = NumIterationsDefault, //in: max number of iterations
+                                  const double timeBudget = 0.0,                           //in: time budget in seconds (0: unlimited)
+                                  const unsigned int seed = 0);                            //in: random seed
+
+ double determineContrSequence(const ContractionGraph & graph,
+                               ContractionSequence & contrSeq) override;
+
+ static const unsigned int NumIterationsDefault = 100000; //default number of iterations
+
+private:
+
+ unsigned int NumIterations; //max number of iterations
+ double TimeBudget;          //time budget in seconds (0: unlimited)
+ unsigned int Seed;          //random seed
+
+};
+
+/** Time-budgeted optimizer of the tensor contraction sequence:
+ Uses the exact optimizer for small tensor networks if its estimated
+ execution time fits into the time budget, otherwise starts
+ from the greedy contraction sequence, tries the beam search if the
+ time budget allows it and spends the rest of the time budget on
+ the stochastic refinement of the best contraction sequence found. **/
+class ContrSeqOptimizerAuto: public ContrSeqOptimizer{
+
+public:
+
+ /** Constructs a time-budgeted optimizer. **/
+ explicit ContrSeqOptimizerAuto(const double timeBudget); //in: time budget in seconds
+
+ double determineContrSequence(const ContractionGraph & graph,
+                               ContractionSequence & contrSeq) override;
+
+private:
+
+ double TimeBudget; //time budget in seconds
+
+};
+
+} //end namespace exatensor
+
+#endif //EXA_CONTR_SEQ_OPTIMIZER_H_
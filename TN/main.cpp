@@ -26,6 +26,12 @@
 #include <memory>
 #include <complex>
 #include <iostream>
+#include <fstream>
+#include <cmath>
+#include <limits>
+#include <cstdio>
+#include <chrono>
+#include <functional>
 
 #include "tensornet.hpp"
 
@@ -197,6 +203,257 @@ int test_tensor_expression(){
  return 0;
 }
 
+/** Builds the contraction graph of a closed 2D grid tensor network with uneven leg extents. **/
+exatensor::ContractionGraph build_grid_graph(const unsigned int rows, const unsigned int cols){
+ exatensor::ContractionGraph graph(rows*cols);
+ for(unsigned int r = 0; r < rows; ++r){
+  for(unsigned int c = 0; c < cols; ++c){
+   const unsigned int id = r*cols + c + 1;
+   if(c+1 < cols) graph.appendEdge(id,id+1,2+(r*7+c*3)%5);     //horizontal leg
+   if(r+1 < rows) graph.appendEdge(id,id+cols,2+(r*3+c*5)%4);  //vertical leg
+  }
+ }
+ return graph;
+}
+
+/** Builds a tensor network (without tensor bodies) with a given contraction graph. **/
+exatensor::TensorNetwork<double> build_graph_network(const exatensor::ContractionGraph & graph){
+ exatensor::TensorNetwork<double> tensnet;
+ std::size_t dims[32];
+ for(unsigned int t = 0; t <= graph.getNumTensors(); ++t){
+  const auto & edges = graph.getTensorEdges(t);
+  std::vector<exatensor::TensorLeg> legs;
+  for(unsigned int i = 0; i < edges.size(); ++i){
+   const auto & edge = graph.getEdge(edges[i]);
+   const unsigned int other = (edge.TensId1 == t) ? edge.TensId2 : edge.TensId1;
+   const auto & otherEdges = graph.getTensorEdges(other);
+   const unsigned int otherLeg = std::find(otherEdges.cbegin(),otherEdges.cend(),edges[i]) - otherEdges.cbegin();
+   dims[i] = edge.Extent; legs.emplace_back(exatensor::TensorLeg(other,otherLeg));
+  }
+  tensnet.appendTensor(exatensor::TensorDenseAdpt<double>(edges.size(),dims),legs);
+ }
+ return tensnet;
+}
+
+int test_contr_seq_optimizers(){
+
+ //Type aliases:
+ using TensorNetwork = exatensor::TensorNetwork<double>;
+ using ContractionSequence = exatensor::ContractionSequence;
+
+ //Build a 3x4 grid tensor network on which the greedy optimizer is not optimal (tensor bodies are not needed for planning):
+ const TensorNetwork tensnet = build_graph_network(build_grid_graph(3,4));
+ const unsigned int NUM_TENSORS = tensnet.getNumTensors();
+ const auto graph = tensnet.getContractionGraph();
+
+ //Replays a contraction sequence via TensorNetwork<T>::getContractionCost:
+ auto replayCost = [&tensnet](const ContractionSequence & contrSeq){
+  TensorNetwork net(tensnet); double cost = 0.0;
+  for(const auto & cPair: contrSeq){cost+=net.getContractionCost(cPair.first,cPair.second); net.contractTensors(cPair.first,cPair.second);}
+  return cost;
+ };
+
+ //Run all contraction sequence optimizers:
+ exatensor::ContrSeqOptimizerBeam beam(64);
+ exatensor::ContrSeqOptimizerGreedy greedy;
+ exatensor::ContrSeqOptimizerDP exact;
+ exatensor::ContrSeqOptimizerAnneal anneal(20000);
+ exatensor::ContrSeqOptimizerAuto automatic(0.1);
+ std::vector<std::pair<std::string,exatensor::ContrSeqOptimizer*>> optimizers{
+  {"Beam",&beam},{"Greedy",&greedy},{"DP",&exact},{"Anneal",&anneal},{"Auto",&automatic}};
+ std::vector<double> costs;
+ for(auto & optimizer: optimizers){
+  ContractionSequence contrSeq;
+  double cost = optimizer.second->determineContrSequence(graph,contrSeq);
+  double rcost = replayCost(contrSeq);
+  std::cout << optimizer.first << " contraction sequence cost = " << cost << " (replayed " << rcost << ")" << std::endl;
+  if(contrSeq.size() != NUM_TENSORS-1) return 1;
+  if(std::abs(cost-rcost) > 1e-9*rcost) return 2;
+  costs.emplace_back(cost);
+ }
+ for(const auto cost: costs) if(costs[2] > cost*(1.0+1e-12)) return 3; //DP is exact
+ if(costs[0] > costs[1]) return 11; //beam search is not worse than the greedy search
+ if(costs[2] >= costs[1]) return 12; //greedy search is not optimal on this tensor network
+
+ //Refine the greedy contraction sequence:
+ ContractionSequence contrSeq;
+ double gcost = greedy.determineContrSequence(graph,contrSeq);
+ double acost = anneal.determineContrSequence(graph,contrSeq);
+ std::cout << "Refined greedy contraction sequence cost = " << acost << " (was " << gcost << ")" << std::endl;
+ if(acost > gcost) return 4;
+
+ //Exact optimizer must find the known optimum of a small tensor network (exhaustive enumeration of all contraction sequences):
+ {
+  const auto small = build_grid_graph(2,3);
+  double optCost = std::numeric_limits<double>::infinity();
+  ContractionSequence seq;
+  std::function<void(unsigned int)> enumerate = [&](unsigned int numLeft){
+   if(numLeft == 1){optCost = std::min(optCost,small.getSequenceCost(seq)); return;}
+   for(unsigned int i = 1; i < numLeft; ++i){
+    for(unsigned int j = i + 1; j <= numLeft; ++j){seq.emplace_back(i,j); enumerate(numLeft-1); seq.pop_back();}
+   }
+  };
+  enumerate(small.getNumTensors());
+  contrSeq.clear(); const double dcost = exact.determineContrSequence(small,contrSeq);
+  contrSeq.clear(); const double scost = greedy.determineContrSequence(small,contrSeq);
+  std::cout << "Small tensor network: Optimal contraction sequence cost = " << optCost << ": DP " << dcost << ", Greedy " << scost << std::endl;
+  if(std::abs(dcost-optCost) > 1e-12*optCost || scost <= optCost) return 13;
+ }
+
+ //Rescaled cost cannot be below the Flop count:
+ contrSeq.clear(); exact.determineContrSequence(graph,contrSeq);
+ if(graph.getSequenceCost(contrSeq,exatensor::ContrCostModel(1e9,1e9)) < costs[2]) return 5;
+
+ //Cap intermediate tensors strictly below the largest intermediate of the Flop-optimal contraction sequence of a 2x5 grid:
+ {
+  const auto strip = build_grid_graph(2,5); //a feasible contraction sequence exists under the cap
+  contrSeq.clear(); const double optCost = exact.determineContrSequence(strip,contrSeq);
+  double optVol = 0.0;
+  strip.getSequencePeakVolume(contrSeq,&optVol);
+  const double volCap = optVol - 1.0;
+  exatensor::ContrCostModel costModel(0.0,0.0,sizeof(double),static_cast<std::size_t>(volCap)*sizeof(double));
+  for(auto & optimizer: optimizers){
+   optimizer.second->setCostModel(costModel);
+   contrSeq.clear();
+   const double cost = optimizer.second->determineContrSequence(strip,contrSeq);
+   double vol = 0.0;
+   strip.getSequencePeakVolume(contrSeq,&vol);
+   std::cout << optimizer.first << " memory-capped contraction sequence cost = " << cost << " (unconstrained " << optCost
+             << "): Largest intermediate = " << vol << " (cap " << volCap << ")" << std::endl;
+   if(contrSeq.size() != strip.getNumTensors()-1) return 6;
+   if(cost == std::numeric_limits<double>::infinity() || vol > volCap || cost < optCost) return 7;
+  }
+  //A memory cap which cannot be met must be rejected:
+  const double badCap = 3.0; //any pairwise contraction of the grid produces a larger intermediate
+  costModel = exatensor::ContrCostModel(0.0,0.0,sizeof(double),static_cast<std::size_t>(badCap)*sizeof(double));
+  for(auto & optimizer: optimizers){
+   optimizer.second->setCostModel(costModel);
+   contrSeq.clear();
+   const double cost = optimizer.second->determineContrSequence(strip,contrSeq);
+   std::cout << optimizer.first << " contraction sequence cost under an infeasible memory cap = " << cost << std::endl;
+   if(cost != std::numeric_limits<double>::infinity()) return 8;
+  }
+  for(auto & optimizer: optimizers) optimizer.second->setCostModel(exatensor::ContrCostModel());
+ }
+
+ //Time-budgeted optimizer must not run the exact optimizer beyond its time budget:
+ {
+  const double TIME_BUDGET = 0.05; //seconds
+  const auto grid = build_grid_graph(4,5); //20 tensors: within the exact optimizer limit, but too expensive for the time budget
+  exatensor::ContrSeqOptimizerAuto budgeted(TIME_BUDGET);
+  contrSeq.clear();
+  const auto timeBeg = std::chrono::steady_clock::now();
+  const double cost = budgeted.determineContrSequence(grid,contrSeq);
+  const double timeTot = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now()-timeBeg).count();
+  std::cout << "Auto contraction sequence cost for a 4x5 grid = " << cost << " (" << timeTot << " sec, budget " << TIME_BUDGET << " sec)" << std::endl;
+  if(contrSeq.size() != grid.getNumTensors()-1) return 9;
+  if(timeTot > 20.0*TIME_BUDGET) return 10;
+ }
+
+ //Done:
+ return 0;
+}
+
+int test_sliced_evaluation(){
+
+ //Parameters:
+ const std::size_t TENS_DIM_EXT=3;
+ const std::size_t MEM_LIMIT=1000; //memory limit for intermediate tensors (bytes)
+
+ //Type aliases:
+ using TensDataType = double;
+ using Tensor = exatensor::TensorDenseAdpt<TensDataType>;
+ using TensorNetwork = exatensor::TensorNetwork<TensDataType>;
+ using ContractionSequence = exatensor::ContractionSequence;
+ using PairUnsignedInt = std::pair<unsigned int, unsigned int>;
+
+ //Build a tensor network with defined input tensors:
+ auto buildNetwork = [&](){
+  const unsigned int ranks[] = {4,4,4,5,4,5};
+  const std::vector<std::vector<PairUnsignedInt>> legPairs{{},{{2,0},{3,1}},{{1,0},{2,1}},{{0,0},{2,1},{3,2}},{{2,0},{0,1}},{{0,0},{1,1}}};
+  TensorNetwork tensnet;
+  std::size_t dims[8];
+  for(unsigned int n = 0; n < 6; ++n){
+   for(unsigned int i = 0; i < ranks[n]; ++i) dims[i]=TENS_DIM_EXT;
+   Tensor tensor(ranks[n],dims);
+   const auto vol = tensor.getVolume();
+   std::shared_ptr<TensDataType> body(new TensDataType[vol], [](TensDataType * p){delete[] p;});
+   for(std::size_t i = 0; i < vol; ++i) body.get()[i] = static_cast<TensDataType>((i*(n+3))%11) / 10.0 - 0.5;
+   tensor.setBody(body);
+   tensnet.appendTensor(tensor,legPairs[n]);
+  }
+  tensnet.allocateOutputBody();
+  return tensnet;
+ };
+
+ int error_code = exatensor::start(16*1024*1024); if(error_code != 0) return 1;
+ //Reference evaluation:
+ TensorNetwork tensnet0 = buildNetwork();
+ ContractionSequence contrSeq;
+ error_code = tensnet0.evaluate(contrSeq); if(error_code != 0) return 2;
+ //Sliced evaluation (concurrent slices even on a single core):
+ TensorNetwork tensnet1 = buildNetwork();
+#ifdef _OPENMP
+ const int numThreads = omp_get_max_threads();
+ omp_set_num_threads(std::max(numThreads,4));
+#endif
+ error_code = tensnet1.evaluateSliced(contrSeq,MEM_LIMIT);
+#ifdef _OPENMP
+ omp_set_num_threads(numThreads);
+#endif
+ if(error_code != 0) return 3;
+ //Cached contraction plan (survives saving/loading):
+ auto & planCache = exatensor::ContrPlanCache::getCache();
+ if(planCache.save("contr_plans.txt") != 0) return 6;
+ const auto numPlans = planCache.getNumPlans();
+ planCache.clear();
+ if(planCache.load("contr_plans.txt") != 0 || planCache.getNumPlans() != numPlans) return 7;
+ {//Plans referring to nonexistent operands are rejected on loading (they will be rebuilt):
+  std::ifstream goodFile("contr_plans.txt");
+  std::ofstream badFile("contr_plans_bad.txt");
+  std::string line;
+  bool corrupted = false;
+  while(std::getline(goodFile,line)){
+   if(!corrupted && line.compare(0,5,"STEP ") == 0){line = "STEP -99" + line.substr(line.find(' ',5)); corrupted = true;}
+   badFile << line << std::endl;
+  }
+  badFile.close();
+  planCache.clear();
+  if(!corrupted || planCache.load("contr_plans_bad.txt") != 0 || planCache.getNumPlans() != numPlans - 1) return 11;
+  std::remove("contr_plans_bad.txt");
+  planCache.clear();
+  if(planCache.load("contr_plans.txt") != 0 || planCache.getNumPlans() != numPlans) return 7;
+ }
+ std::remove("contr_plans.txt");
+ TensorNetwork tensnet2 = buildNetwork();
+ ContractionSequence cachedSeq;
+ error_code = tensnet2.evaluate(cachedSeq); if(error_code != 0) return 8;
+ if(cachedSeq != contrSeq) return 9;
+ error_code = exatensor::stop(); if(error_code != 0) return 4;
+ //Compare the results:
+ const auto & tens0 = tensnet0.getTensor(0);
+ const auto & tens1 = tensnet1.getTensor(0);
+ const TensDataType * body0 = tens0.getBodyAccess().get();
+ const TensDataType * body1 = tens1.getBodyAccess().get();
+ double norm = 0.0, diff = 0.0;
+ for(std::size_t i = 0; i < tens0.getVolume(); ++i){norm += std::abs(body0[i]); diff += std::abs(body0[i]-body1[i]);}
+ std::cout << "Sliced evaluation: Norm = " << norm << "; Difference = " << diff << std::endl;
+ if(norm == 0.0 || !(diff <= 1e-10*norm)) return 5;
+ const TensDataType * body2 = tensnet2.getTensor(0).getBodyAccess().get();
+ diff = 0.0;
+ for(std::size_t i = 0; i < tens0.getVolume(); ++i) diff += std::abs(body0[i]-body2[i]);
+ if(!(diff <= 1e-10*norm)) return 10;
+
+ //Done:
+ return 0;
+}
+
 int main(int argc, char ** argv){
+ int error_code = test_contr_seq_optimizers();
+ std::cout << "Contraction sequence optimizers: Status " << error_code << std::endl;
+ if(error_code != 0) return error_code;
+ error_code = test_sliced_evaluation();
+ std::cout << "Sliced tensor network evaluation: Status " << error_code << std::endl;
+ if(error_code != 0) return error_code;
  return test_tensor_expression();
 }
@@ -83,6 +83,51 @@ const TensorConn<T> & TensorNetwork<T>::getTensorConn(const unsigned int id) con
  return Tensors[id];
 }
 
+/** Returns the compact contraction graph of the tensor network (topology and leg extents only). **/
+template <typename T>
+ContractionGraph TensorNetwork<T>::getContractionGraph(std::vector<std::vector<unsigned int>> * legToEdge) const
+{
+ const auto numTensors = this->getNumTensors();
+ ContractionGraph graph(numTensors);
+ std::vector<std::vector<unsigned int>> legEdges(numTensors+1); //edge id for each leg of each r.h.s. tensor
+ for(unsigned int i = 1; i <= numTensors; ++i) legEdges[i].resize(Tensors[i].getNumLegs());
+ for(unsigned int i = 1; i <= numTensors; ++i){
+  const auto & tensor = Tensors[i];
+  const auto numLegs = tensor.getNumLegs();
+  for(unsigned int legId = 0; legId < numLegs; ++legId){
+   const auto & leg = tensor.getTensorLeg(legId);
+   const auto connTensId = leg.getTensorId();
+   const auto connTensLegId = leg.getDimensionId();
+   if(connTensId == 0 || connTensId > i || (connTensId == i && connTensLegId > legId)){ //new edge
+    legEdges[i][legId] = graph.appendEdge(i,connTensId,tensor.getDimExtent(legId));
+    if(connTensId != 0) legEdges[connTensId][connTensLegId] = legEdges[i][legId];
+   }
+  }
+ }
+ if(legToEdge != nullptr) *legToEdge = std::move(legEdges);
+ return graph;
+}
+
+/** Returns the canonical topology key of the tensor network: The tensor element type followed by
+    the connections (connected tensor id, its leg id, leg extent) of each leg of each tensor.
+    Tensor networks with the same key share the same tensor contraction plan. **/
+template <typename T>
+std::string TensorNetwork<T>::getTopologyKey() const
+{
+ std::string key = std::to_string(TensorDataKind<T>::Type);
+ for(const auto & tensor: Tensors){
+  const auto numLegs = tensor.getNumLegs();
+  key += ";" + std::to_string(numLegs) + ":";
+  for(unsigned int legId = 0; legId < numLegs; ++legId){
+   const auto & leg = tensor.getTensorLeg(legId);
+   if(legId > 0) key += ",";
+   key += std::to_string(leg.getTensorId()) + "." + std::to_string(leg.getDimensionId()) + "."
+        + std::to_string(tensor.getDimExtent(legId));
+  }
+ }
+ return key;
+}
+
 /** Prints. **/
 template <typename T>
 void TensorNetwork<T>::printIt() const
@@ -512,7 +557,7 @@ double TensorNetwork<T>::getContractionCost(const unsigned int tensId1, //in: id
  if(arithmIntensity != nullptr) *arithmIntensity = arithInt;
  //Rescale the cost due to arithmetic intensity:
  if(rescale){
-  //`Finish
+  cost = this->getCostModel().getCost(lTensVol,rTensVol,cVol);
  }
  return cost;
 }
@@ -521,7 +566,8 @@ double TensorNetwork<T>::getContractionCost(const unsigned int tensId1, //in: id
     for the given tensor network and numerically evaluates these
     tensor contractions to produce the value of the output tensor.
     If "contrSeq" already contains the previously determined
-    contraction sequence, it will be used immediately. **/
+    contraction sequence, it will be used immediately. Otherwise the contraction
+    sequence cached for the same tensor network topology will be reused, if any. **/
 template <typename T>
 int TensorNetwork<T>::evaluate(ContractionSequence & contrSeq,
                                const unsigned int numWalkers)
@@ -530,11 +576,22 @@ int TensorNetwork<T>::evaluate(ContractionSequence & contrSeq,
  auto numTensors = this->getNumTensors(); //number of r.h.s. tensors in the tensor network
  auto numContr = contrSeq.size(); //number of tensor contractions in the contraction sequence
  if(numContr == 0){ //contraction sequence has not been determined yet
-  this->getContractionSequence(contrSeq,numWalkers);
+  ContractionPlan plan;
+  if(ContrPlanCache::getCache().findPlan(this->getTopologyKey(),plan)){ //reuse the cached contraction sequence
+   contrSeq = plan.ContrSeq;
+  }else{
+   this->getContractionSequence(contrSeq,numWalkers);
+  }
  }else{
   if(numContr != (numTensors - 1)) error_code=-1; //invalid number of tensor contractions in the contraction sequence
  }
- if(error_code == 0) error_code = this->computeOutputLocal(contrSeq);
+ if(error_code == 0){
+  if(this->fitsHostBuffer(contrSeq)){
+   error_code = this->computeOutputLocal(contrSeq);
+  }else{ //intermediate tensors will not fit into the Host buffer: evaluate the tensor network in slices
+   error_code = this->computeOutputSliced(contrSeq,talshDeviceBufferSize(0,DEV_HOST),talshDeviceTensorSize(0,DEV_HOST));
+  }
+ }
  return error_code;
 }
 
@@ -555,6 +612,66 @@ int TensorNetwork<T>::evaluate(ContractionSequence & contrSeq,
  return error_code;
 }
 
+/** Determines a pseudo-optimal sequence of tensor contractions
+    for the given tensor network by means of a user-chosen optimizer
+    and numerically evaluates these tensor contractions to produce
+    the value of the output tensor. If "contrSeq" already contains
+    the previously determined contraction sequence, it will be used immediately. **/
+template <typename T>
+int TensorNetwork<T>::evaluate(ContractionSequence & contrSeq,
+                               ContrSeqOptimizer & optimizer)
+{
+ int error_code = 0; //success
+ auto numTensors = this->getNumTensors(); //number of r.h.s. tensors in the tensor network
+ auto numContr = contrSeq.size(); //number of tensor contractions in the contraction sequence
+ if(numContr == 0){ //contraction sequence has not been determined yet
+  this->getContractionSequence(contrSeq,optimizer);
+ }else{
+  if(numContr != (numTensors - 1)) error_code=-1; //invalid number of tensor contractions in the contraction sequence
+ }
+ if(error_code == 0){
+  if(this->fitsHostBuffer(contrSeq)){
+   error_code = this->computeOutputLocal(contrSeq);
+  }else{ //intermediate tensors will not fit into the Host buffer: evaluate the tensor network in slices
+   error_code = this->computeOutputSliced(contrSeq,talshDeviceBufferSize(0,DEV_HOST),talshDeviceTensorSize(0,DEV_HOST));
+  }
+ }
+ return error_code;
+}
+
+/** Determines a pseudo-optimal sequence of tensor contractions
+    for the given tensor network and numerically evaluates these
+    tensor contractions to produce the value of the output tensor,
+    slicing the tensor network such that the intermediate tensors
+    fit into the given memory limit. If "contrSeq" already contains
+    the previously determined contraction sequence, it will be used immediately,
+    otherwise the cached one will be reused, if any. **/
+template <typename T>
+int TensorNetwork<T>::evaluateSliced(ContractionSequence & contrSeq,
+                                     const std::size_t memLimit,
+                                     const unsigned int numWalkers)
+{
+ int error_code = 0; //success
+ auto numTensors = this->getNumTensors(); //number of r.h.s. tensors in the tensor network
+ auto numContr = contrSeq.size(); //number of tensor contractions in the contraction sequence
+ if(numContr == 0){ //contraction sequence has not been determined yet
+  ContractionPlan plan;
+  if(ContrPlanCache::getCache().findPlan(this->getTopologyKey(),plan)){ //reuse the cached contraction sequence
+   contrSeq = plan.ContrSeq;
+  }else{
+   this->getContractionSequence(contrSeq,numWalkers);
+  }
+ }else{
+  if(numContr != (numTensors - 1)) error_code=-1; //invalid number of tensor contractions in the contraction sequence
+ }
+ if(error_code == 0){
+  std::size_t bufSize = talshDeviceBufferSize(0,DEV_HOST);
+  if(bufSize == 0 || (memLimit > 0 && memLimit < bufSize)) bufSize = memLimit;
+  error_code = this->computeOutputSliced(contrSeq,bufSize,talshDeviceTensorSize(0,DEV_HOST));
+ }
+ return error_code;
+}
+
 /** Determines the pseudo-optimal tensor contraction sequence and returns
     it as a vector of pairs of the r.h.s. tensor id's to contract. Note that
     each subsequent pair will have its tensor id's refer to the corresponding
@@ -563,8 +680,6 @@ template <typename T>
 void TensorNetwork<T>::getContractionSequence(ContractionSequence & contrSeq,
                                               const unsigned int numWalkers) const
 {
- using ContrPath = std::tuple<TensorNetwork<T>,ContractionSequence,double>;
-
  std::cout << "#MSG(TensorNetwork<T>::getContractionSequence): Determining a pseudo-optimal tensor contraction sequence ... "; //debug
 
  auto timeBeg = std::chrono::high_resolution_clock::now();
@@ -573,45 +688,10 @@ void TensorNetwork<T>::getContractionSequence(ContractionSequence & contrSeq,
  assert(numContractions > 0); //at least one tensor contraction is expected (two or more r.h.s. tensors)
  assert(contrSeq.size() == 0); //the contraction sequence must be empty on entrance
 
- ContractionSequence contrSeqEmpty;
- std::vector<ContrPath> inputPaths; //input: vector
- inputPaths.emplace_back(std::make_tuple(*this,contrSeqEmpty,0.0)); //initial configuration
-
- auto cmpPaths = [](const ContrPath & left, const ContrPath & right){return (std::get<2>(left) < std::get<2>(right));};
- std::priority_queue<ContrPath,std::vector<ContrPath>,decltype(cmpPaths)> priq(cmpPaths); //output: priority queue
-
- for(decltype(numContractions) pass = 0; pass < numContractions; ++pass){
-  unsigned int numPassCands = 0;
-  for(const auto & contrPath : inputPaths){
-   const auto & parentTensNet = std::get<0>(contrPath); //parental tensor network
-   const auto numTensors = parentTensNet.getNumTensors(); //number of r.h.s. tensors in the parental tensor network
-   const auto & parentContrSeq = std::get<1>(contrPath); //parental contraction sequence
-   for(unsigned int i = 1; i < numTensors; ++i){ //r.h.s. tensors are numbered from 1
-    for(unsigned int j=i+1; j <= numTensors; ++j){ //r.h.s. tensors are numbered from 1
-     double contrCost = parentTensNet.getContractionCost(i,j); //tensor contraction cost
-     //std::cout << std::endl << "New candidate contracted pair of tensors is {" << i << "," << j << "} with cost " << contrCost; //debug
-     auto tensNet = parentTensNet.contractTensorsOut(i,j); //contract tensors i and j and return a pointer to a new tensor network
-     auto cSeq = parentContrSeq; cSeq.emplace_back(std::pair<unsigned int, unsigned int>(i,j)); //append a new pair of contracted tensor id's
-     priq.emplace(std::make_tuple(*tensNet,cSeq,contrCost+std::get<2>(contrPath))); //cloning tensor network and contraction sequence
-     if(priq.size() > numWalkers) priq.pop();
-     numPassCands++;
-    }
-   }
-  }
-  std::cout << std::endl << "Pass " << pass << ": Total number of candidates considered = " << numPassCands; //debug
-  inputPaths.clear();
-  if(pass == numContractions - 1){ //last pass
-   while(priq.size() > 1) priq.pop();
-   contrSeq = std::get<1>(priq.top());
-   std::cout << std::endl << "Best tensor contraction sequence cost found = " << std::get<2>(priq.top()); //debug
-   priq.pop();
-  }else{
-   while(priq.size() > 0){
-    inputPaths.emplace_back(priq.top());
-    priq.pop();
-   }
-  }
- }
+ ContrSeqOptimizerBeam optimizer(numWalkers);
+ optimizer.setCostModel(this->getCostModel());
+ double contrCost = optimizer.determineContrSequence(this->getContractionGraph(),contrSeq);
+ std::cout << std::endl << "Best tensor contraction sequence cost found = " << contrCost; //debug
 
  auto timeEnd = std::chrono::high_resolution_clock::now();
  auto timeTot = std::chrono::duration_cast<std::chrono::duration<double>>(timeEnd-timeBeg);
@@ -621,144 +701,443 @@ void TensorNetwork<T>::getContractionSequence(ContractionSequence & contrSeq,
  return;
 }
 
+/** Determines the pseudo-optimal tensor contraction sequence by means of a given optimizer. **/
+template <typename T>
+void TensorNetwork<T>::getContractionSequence(ContractionSequence & contrSeq,
+                                              ContrSeqOptimizer & optimizer) const
+{
+ std::cout << "#MSG(TensorNetwork<T>::getContractionSequence): Determining a pseudo-optimal tensor contraction sequence ... "; //debug
+ auto timeBeg = std::chrono::high_resolution_clock::now();
+ assert(this->getNumTensors() > 1); //at least one tensor contraction is expected (two or more r.h.s. tensors)
+ assert(contrSeq.size() == 0); //the contraction sequence must be empty on entrance
+ optimizer.setCostModel(this->getCostModel());
+ double contrCost = optimizer.determineContrSequence(this->getContractionGraph(),contrSeq);
+ auto timeEnd = std::chrono::high_resolution_clock::now();
+ auto timeTot = std::chrono::duration_cast<std::chrono::duration<double>>(timeEnd-timeBeg);
+ std::cout << std::endl << "Best tensor contraction sequence cost found = " << contrCost; //debug
+ std::cout << std::endl << "Done (" << timeTot.count() << " sec):"; //debug
+ for(const auto & cPair : contrSeq) std::cout << " {" << std::get<0>(cPair) << "," << std::get<1>(cPair) << "}"; //debug
+ std::cout << std::endl; //debug
+ return;
+}
+
+/** Returns the cost model of tensor contractions for the tensor element type. **/
+template <typename T>
+ContrCostModel TensorNetwork<T>::getCostModel() const
+{
+ ContrCostModel costModel = ContrCostModel::getDefault();
+ costModel.ElemSize = sizeof(T);
+ return costModel;
+}
+
+/** Retrieves the tensor contraction plan for a given contraction sequence from the plan cache,
+    or builds it by replaying the contraction sequence symbolically and caches it: Each tensor
+    contraction of the plan refers to its operands (r.h.s. tensors or preceding tensor contractions)
+    and carries its digital and symbolic tensor contraction patterns, the destination tensor shape
+    and the memory slot of the destination tensor. **/
+template <typename T>
+int TensorNetwork<T>::getContractionPlan(const ContractionSequence & contrSeq,
+                                         ContractionPlan & plan) const
+{
+ int errc,cpl,lRank,rRank,contrPtrnDig[MAX_TENSOR_RANK*2];
+ char contrPtrnSym[512]; //should be large enough to contain an arbitrary binary tensor contraction specification
+
+ const auto key = this->getTopologyKey();
+ auto & cache = ContrPlanCache::getCache();
+ if(cache.findPlan(key,plan) && plan.ContrSeq == contrSeq) return 0;
+
+ const auto numTensors = this->getNumTensors();
+ const auto numContractions = contrSeq.size();
+ if(numContractions != (numTensors - 1)) return -1;
+ plan.ContrSeq = contrSeq;
+ plan.Steps.assign(numContractions,ContrPlanStep());
+ std::vector<int> producer(numTensors + 1); //current r.h.s. tensor id --> its producer
+ for(unsigned int i = 1; i <= numTensors; ++i) producer[i] = -static_cast<int>(i);
+ TensorNetwork<T> tensNet(*this);
+ for(decltype(plan.Steps.size()) contrNum = 0; contrNum < numContractions; ++contrNum){
+  auto lid = std::get<0>(contrSeq[contrNum]); //left input tensor id
+  auto rid = std::get<1>(contrSeq[contrNum]); //right input tensor id
+  assert(lid > 0 && lid < rid); //r.h.s. tensor id is always > 0 (0 is the output tensor)
+  auto & step = plan.Steps[contrNum];
+  step.Operands[0] = producer[lid]; step.Operands[1] = producer[rid];
+  lRank = tensNet.getTensor(lid).getRank(); rRank = tensNet.getTensor(rid).getRank();
+  tensNet.contractTensors(lid,rid,contrPtrnDig);
+  producer[lid] = static_cast<int>(contrNum); producer.erase(producer.begin() + rid);
+  const auto & resultTensor = tensNet.getTensor((contrNum == numContractions - 1) ? 0 : lid);
+  auto pDims = resultTensor.getDimExtents();
+  for(unsigned int i = 0; i < resultTensor.getRank(); ++i) step.Dims.emplace_back(static_cast<int>(pDims[i]));
+  step.ContrPtrnDig.assign(contrPtrnDig,contrPtrnDig+lRank+rRank);
+  int conj = 0;
+  get_contr_pattern_sym(&lRank,&rRank,&conj,contrPtrnDig,contrPtrnSym,&cpl,&errc); if(errc != TALSH_SUCCESS) return -1;
+  step.ContrPtrnSym = std::string(contrPtrnSym,cpl);
+ }
+ assert(producer.size() == 2 && producer[1] == static_cast<int>(numContractions - 1));
+ plan.assignSlots();
+ cache.storePlan(key,plan);
+ return 0;
+}
+
+/** Returns TRUE if the intermediate tensors of a tensor contraction sequence
+    will fit into the Host argument buffer of TAL-SH (they are allocated there):
+    Each intermediate tensor must not exceed the max tensor size of the buffer,
+    and all simultaneously existing ones together must not exceed the buffer size. **/
+template <typename T>
+bool TensorNetwork<T>::fitsHostBuffer(const ContractionSequence & contrSeq) const
+{
+ const std::size_t bufSize = talshDeviceBufferSize(0,DEV_HOST);
+ if(bufSize == 0) return true; //TAL-SH has not been initialized: Nothing to check
+ const std::size_t tensSize = talshDeviceTensorSize(0,DEV_HOST);
+ double maxVol = 0.0;
+ const double peakVol = this->getContractionGraph().getSequencePeakVolume(contrSeq,&maxVol);
+ if(peakVol * static_cast<double>(sizeof(T)) > static_cast<double>(bufSize) ||
+    maxVol * static_cast<double>(sizeof(T)) > static_cast<double>(tensSize)){
+  std::cout << "#MSG(TensorNetwork<T>::fitsHostBuffer): Intermediate tensors require " << peakVol * sizeof(T)
+            << " bytes (largest " << maxVol * sizeof(T) << " bytes) while the Host buffer size is " << bufSize
+            << " bytes (max tensor size " << tensSize << " bytes)" << std::endl;
+  return false;
+ }
+ return true;
+}
+
 /** Performs all tensor contractions, thus evaluating the value of the output tensor.
-    Single-node version based on TAL-SH. **/
+    Single-node version based on TAL-SH: The (cached) tensor contraction plan is turned into
+    a dependency graph (tree) of tensor contractions, and the tensor contractions whose
+    input tensors are ready are issued asynchronously via TAL-SH tasks. The intermediate
+    tensors live in the memory slots of the plan (see ContractionPlan::assignSlots()),
+    which are allocated once up front (preferably in the TAL-SH Host buffer) and recycled
+    in the planned order, thus avoiding any memory allocation during the execution.
+    TAL-SH calls are serialized by the critical section <talsh_api> (concurrent slices),
+    a thread waiting on a TAL-SH task does not hold it. **/
 template <typename T>
 int TensorNetwork<T>::computeOutputLocal(const ContractionSequence & contrSeq)
 {
- talsh_task_t tsk;
- talsh_tens_t *tens, *dtens, *ltens, *rtens;
- int errc,cpl,lRank,rRank,tDims[MAX_TENSOR_RANK],contrPtrnDig[MAX_TENSOR_RANK*2];
- char contrPtrnSym[512]; //should be large enough to contain an arbitrary binary tensor contraction specification
+ //Tensor contraction (node of the dependency graph):
+ struct ContrNode{
+  int Operand[2];         //left/right input tensor: >=0: producing tensor contraction; <0: -(r.h.s. tensor id)
+  std::string Pattern;    //symbolic tensor contraction pattern
+  std::size_t Size;       //size of the destination tensor in bytes (0 for the output tensor)
+  int Slot;               //memory slot of the destination tensor (-1 for the output tensor)
+  talsh_tens_t * Dest;    //destination tensor
+  talsh_task_t * Task;    //TAL-SH task
+  int Status;             //0: pending; 1: issued; 2: completed
+ };
+ //Memory slot of the intermediate tensors:
+ struct MemSlot{
+  void * Body;             //slot memory
+  std::vector<int> Owners; //tensor contractions producing intermediate tensors in this slot (in order)
+  std::size_t Turn;        //current owner (position in Owners)
+  bool Busy;               //TRUE if the current owner is live
+ };
+
+ int errc;
 
  int error_code = 0; //success
  std::cout << "#MSG(TensorNetwork<T>::computeOutputLocal): Computing ... "; //debug
  auto timeBeg = std::chrono::high_resolution_clock::now();
 
- std::map<std::uintptr_t,std::pair<talsh_tens_t*,std::shared_ptr<T>>> tensMap; //body address --> {TAL-SH tensor pointer, tensor body pointer}
+ const auto numTensors = this->getNumTensors();
+ const auto numContractions = contrSeq.size();
+ assert(numContractions == (numTensors - 1));
+ const int hostId = talshFlatDevId(DEV_HOST,0);
 
- auto numContractions = contrSeq.size();
- assert(numContractions == (this->getNumTensors() - 1));
- std::unique_ptr<TensorNetwork<T>> tensNet(this);
- for(decltype(numContractions) contrNum = 0; contrNum < numContractions; ++contrNum){
+ //Build the dependency graph from the (cached) tensor contraction plan:
+ ContractionPlan plan;
+ errc = this->getContractionPlan(contrSeq,plan); if(errc != 0) return -1;
+ std::vector<ContrNode> nodes(numContractions);
+ std::vector<MemSlot> slots(plan.SlotVolumes.size(),MemSlot{nullptr,std::vector<int>(),0,false});
+ for(decltype(nodes.size()) contrNum = 0; contrNum < numContractions; ++contrNum){
+  const auto & step = plan.Steps[contrNum];
+  auto & node = nodes[contrNum];
+  node.Operand[0] = step.Operands[0]; node.Operand[1] = step.Operands[1];
+  node.Pattern = step.ContrPtrnSym;
+  std::size_t vol = 1; for(const auto dim: step.Dims) vol *= static_cast<std::size_t>(dim);
+  node.Size = (step.Slot < 0) ? 0 : vol * sizeof(T);
+  node.Slot = step.Slot;
+  node.Dest = nullptr; node.Task = nullptr; node.Status = 0;
+  if(node.Slot >= 0) slots[node.Slot].Owners.emplace_back(static_cast<int>(contrNum));
+ }
 
-  //Extract the pair of contracted input tensors:
-  auto lid = std::get<0>(contrSeq[contrNum]); //left input tensor id
-  auto rid = std::get<1>(contrSeq[contrNum]); //right input tensor id
-  assert(lid > 0 && lid < rid); //r.h.s. tensor id is always > 0 (0 is the output tensor)
+ //Waits upon a TAL-SH task without blocking other threads issuing TAL-SH calls:
+ auto taskWait = [](talsh_task_t * task, int * stats){
+  int done = NOPE, ierr = TALSH_SUCCESS;
+  while(true){
+#pragma omp critical(talsh_api)
+   done = talshTaskComplete(task,stats,&ierr);
+   if(ierr != TALSH_SUCCESS) return ierr;
+   if(done == YEP) break;
+   std::this_thread::yield();
+  }
+  return static_cast<int>(TALSH_SUCCESS);
+ };
 
-  //Construct the left tensor:
-  auto & leftTensor = tensNet->getTensor(lid); //left tensor
-  int tRank = leftTensor.getRank(); lRank=tRank;
-  auto pDims = leftTensor.getDimExtents();
-  for(int i = 0; i < tRank; ++i) tDims[i] = static_cast<int>(pDims[i]);
-  auto pBody = leftTensor.getBodyAccess();
-  void * tBody = static_cast<void*>(pBody.get());
-  assert(tBody != nullptr); //input tensor must have been defined
-  std::uintptr_t lbodyAddr = reinterpret_cast<std::uintptr_t>(tBody);
-  auto tensPos = tensMap.find(lbodyAddr);
-  if(tensPos != tensMap.end()){ //intermediate tensor
-   tens = (tensPos->second).first;
-  }else{ //external input tensor
-   errc = talshTensorCreate(&tens); if(errc != TALSH_SUCCESS) return -1;
-   errc = talshTensorConstruct(tens,TensorDataKind<T>::Type,tRank,tDims,talshFlatDevId(DEV_HOST,0),tBody);
-   if(errc != TALSH_SUCCESS) return -1;
-   tensMap.emplace(lbodyAddr,std::pair<talsh_tens_t*,std::shared_ptr<T>>(tens,std::shared_ptr<T>(nullptr,[](T * ptr){})));
+ //Construct TAL-SH aliases for the input and output tensors (external bodies)
+ //and for the intermediate tensors (bodies in the memory slots):
+ std::vector<talsh_tens_t*> inputs(numTensors + 1,nullptr); //[0]: output tensor
+ auto releaseTensors = [&](){
+  int stats;
+  for(auto & node: nodes){
+   if(node.Task != nullptr){
+    taskWait(node.Task,&stats);
+#pragma omp critical(talsh_api)
+    talshTaskDestroy(node.Task);
+    node.Task = nullptr;
+   }
+   if(node.Dest != nullptr && node.Slot >= 0){
+#pragma omp critical(talsh_api)
+    talshTensorDestroy(node.Dest);
+   }
+   node.Dest = nullptr;
   }
-  ltens = tens;
-
-  //Construct the right tensor:
-  auto & rightTensor = tensNet->getTensor(rid); //right tensor
-  tRank = rightTensor.getRank(); rRank = tRank;
-  pDims = rightTensor.getDimExtents();
-  for(int i = 0; i < tRank; ++i) tDims[i] = static_cast<int>(pDims[i]);
-  pBody = rightTensor.getBodyAccess();
-  tBody = static_cast<void*>(pBody.get());
-  assert(tBody != nullptr); //input tensor must have been defined
-  std::uintptr_t rbodyAddr = reinterpret_cast<std::uintptr_t>(tBody);
-  tensPos = tensMap.find(rbodyAddr);
-  if(tensPos != tensMap.end()){ //intermediate tensor
-   tens = (tensPos->second).first;
-  }else{ //external input tensor
-   errc = talshTensorCreate(&tens); if(errc != TALSH_SUCCESS) return -1;
-   errc = talshTensorConstruct(tens,TensorDataKind<T>::Type,tRank,tDims,talshFlatDevId(DEV_HOST,0),tBody);
-   if(errc != TALSH_SUCCESS) return -1;
-   tensMap.emplace(rbodyAddr,std::pair<talsh_tens_t*,std::shared_ptr<T>>(tens,std::shared_ptr<T>(nullptr,[](T * ptr){})));
+  for(auto & tens: inputs){
+   if(tens != nullptr){
+#pragma omp critical(talsh_api)
+    talshTensorDestroy(tens);
+    tens = nullptr;
+   }
   }
-  rtens = tens;
-
-  std::cout << std::endl << "Left body  = " << lbodyAddr << ": Ref count = " << tensMap[lbodyAddr].second.use_count(); //debug
-  std::cout << std::endl << "Right body = " << rbodyAddr << ": Ref count = " << tensMap[rbodyAddr].second.use_count(); //debug
-  //std::string tmp; std::cout << std::endl << "Press any key and enter to continue ..."; std::cin >> tmp; //debug
-
-  //Construct the destination tensor:
-  decltype(lid) did; //destination tensor id
-  if(contrNum == numContractions - 1){ //last contraction
-   assert(lid == 1 && rid == 2); // last contraction: 0+=1*2
-   auto tmpTensNet = tensNet->contractTensorsOut(lid,rid,contrPtrnDig);
-   did = 0; //output tensor
-  }else{
-   auto tmpTensNet = tensNet->contractTensorsOut(lid,rid,contrPtrnDig);
-   if(contrNum == 0) auto pThis = tensNet.release(); //release "this"
-   tensNet = std::move(tmpTensNet);
-   did = lid;
+  for(auto & slot: slots) if(slot.Body != nullptr) mem_free(hostId,&(slot.Body));
+ };
+ for(unsigned int i = 0; i <= numTensors; ++i){
+  const auto & tensor = this->getTensor(i);
+  const int tRank = tensor.getRank();
+  int tDims[MAX_TENSOR_RANK];
+  auto pDims = tensor.getDimExtents();
+  for(int j = 0; j < tRank; ++j) tDims[j] = static_cast<int>(pDims[j]);
+  auto pBody = tensor.getBodyAccess();
+  void * tBody = static_cast<void*>(pBody.get());
+  assert(tBody != nullptr); //input/output tensor must have been defined
+#pragma omp critical(talsh_api)
+  {
+   errc = talshTensorCreate(&(inputs[i]));
+   if(errc == TALSH_SUCCESS) errc = talshTensorConstruct(inputs[i],TensorDataKind<T>::Type,tRank,tDims,hostId,tBody);
   }
-  auto & resultTensor = tensNet->getTensor(did); //destination tensor
-  tRank = resultTensor.getRank();
-  pDims = resultTensor.getDimExtents();
-  for(int i = 0; i < tRank; ++i) tDims[i] = static_cast<int>(pDims[i]);
-  errc = talshTensorCreate(&tens); if(errc != TALSH_SUCCESS) return -1;
-  std::shared_ptr<T> sBody(nullptr);
-  pBody = resultTensor.getBodyAccess();
-  if(pBody){ //output tensor (already has an external body)
-   tBody = static_cast<void*>(pBody.get());
-   errc = talshTensorConstruct(tens,TensorDataKind<T>::Type,tRank,tDims,talshFlatDevId(DEV_HOST,0),tBody);
-   if(errc != TALSH_SUCCESS) return -1;
-  }else{ //intermediate tensor (body is owned by TAL-SH)
-   errc = talshTensorConstruct(tens,TensorDataKind<T>::Type,tRank,tDims,talshFlatDevId(DEV_HOST,0));
-   if(errc != TALSH_SUCCESS) return -1;
-   errc = talshTensorGetBodyAccess(tens,&tBody,TensorDataKind<T>::Type,0,DEV_HOST);
-   if(errc != TALSH_SUCCESS) return -1;
-   sBody = std::shared_ptr<T>(static_cast<T*>(tBody),[](T * ptr){});
-   tensNet->resetTensorBody(did,sBody);
+  if(errc != TALSH_SUCCESS){releaseTensors(); return -1;}
+ }
+ for(decltype(slots.size()) i = 0; i < slots.size(); ++i){ //Host buffer first, system memory otherwise
+  const std::size_t slotSize = plan.SlotVolumes[i] * sizeof(T);
+  errc = mem_allocate(hostId,slotSize,YEP,&(slots[i].Body));
+  if(errc != 0) errc = mem_allocate(hostId,slotSize,NOPE,&(slots[i].Body));
+  if(errc != 0){slots[i].Body = nullptr; releaseTensors(); return -1;}
+ }
+ for(decltype(nodes.size()) contrNum = 0; contrNum < numContractions - 1; ++contrNum){
+  auto & node = nodes[contrNum];
+  const auto & dims = plan.Steps[contrNum].Dims;
+#pragma omp critical(talsh_api)
+  {
+   errc = talshTensorCreate(&(node.Dest));
+   if(errc == TALSH_SUCCESS) errc = talshTensorConstruct(node.Dest,TensorDataKind<T>::Type,static_cast<int>(dims.size()),
+                                                         dims.data(),hostId,slots[node.Slot].Body);
   }
-  std::uintptr_t dbodyAddr = reinterpret_cast<std::uintptr_t>(tBody);
-  tensMap.emplace(dbodyAddr,std::pair<talsh_tens_t*,std::shared_ptr<T>>(tens,sBody));
-  dtens = tens;
-  std::cout << std::endl << "Intermediate body = " << dbodyAddr << ": Ref count = " << tensMap[dbodyAddr].second.use_count(); //debug
-
-  //Get the symbolic tensor contraction pattern:
-  int conj = 0;
-  get_contr_pattern_sym(&lRank,&rRank,&conj,contrPtrnDig,contrPtrnSym,&cpl,&errc); if(errc != TALSH_SUCCESS) return -1;
+  if(errc != TALSH_SUCCESS){releaseTensors(); return -1;}
+ }
+ nodes[numContractions - 1].Dest = inputs[0];
 
-  //Perform the tensor contraction:
-  errc = talshTensorContract(contrPtrnSym,dtens,ltens,rtens); if(errc != TALSH_SUCCESS) return -1;
-
-  //Destruct processed TAL-SH tensor aliases:
-  // Right input tensor:
-  tens=nullptr; tens=(tensMap[rbodyAddr]).first;
-  assert(tens != nullptr);
-  errc = talshTensorDestroy(tens); if(errc != TALSH_SUCCESS) return -1;
-  tensMap.erase(rbodyAddr);
-  // Left input tensor:
-  tens=nullptr; tens=(tensMap[lbodyAddr]).first;
-  assert(tens != nullptr);
-  errc = talshTensorDestroy(tens); if(errc != TALSH_SUCCESS) return -1;
-  tensMap.erase(lbodyAddr);
-  // Output tensor:
-  if(contrNum == numContractions - 1){ //last tensor contraction
-   tens=nullptr; tens=(tensMap[dbodyAddr]).first;
-   assert(tens != nullptr);
-   errc = talshTensorDestroy(tens); if(errc != TALSH_SUCCESS) return -1;
-   tensMap.erase(dbodyAddr);
+ //Execute the dependency graph:
+ std::size_t numDone = 0, numInFlight = 0;
+ auto operandTensor = [&](int operand){return (operand < 0) ? inputs[-operand] : nodes[operand].Dest;};
+ auto operandReady = [&](int operand){return (operand < 0) || (nodes[operand].Status == 2);};
+ auto slotReady = [&](int contrNum){ //the memory slot is handed over in the planned order only
+  if(nodes[contrNum].Slot < 0) return true;
+  const auto & slot = slots[nodes[contrNum].Slot];
+  return !slot.Busy && slot.Owners[slot.Turn] == contrNum;
+ };
+ while(numDone < numContractions){
+  //Issue the ready tensor contractions (in the order of the contraction sequence):
+  bool issued = false;
+  for(decltype(nodes.size()) contrNum = 0; contrNum < numContractions; ++contrNum){
+   auto & node = nodes[contrNum];
+   if(node.Status != 0 || !operandReady(node.Operand[0]) || !operandReady(node.Operand[1])) continue;
+   if(!slotReady(static_cast<int>(contrNum))) continue; //wait for the memory slot to be released
+   if(node.Slot >= 0) std::memset(slots[node.Slot].Body,0,node.Size); //recycled slot: reset the destination tensor
+#pragma omp critical(talsh_api)
+   {
+    errc = talshTaskCreate(&(node.Task));
+    if(errc == TALSH_SUCCESS){
+     errc = talshTensorContract(node.Pattern.c_str(),node.Dest,operandTensor(node.Operand[0]),operandTensor(node.Operand[1]),
+                                1.0,0.0,DEV_DEFAULT,DEV_DEFAULT,COPY_MTT,YEP,node.Task);
+     if(errc != TALSH_SUCCESS){talshTaskDestroy(node.Task); node.Task = nullptr;}
+    }else{
+     node.Task = nullptr; errc = TALSH_FAILURE;
+    }
+   }
+   if(errc != TALSH_SUCCESS){
+    if((errc == TRY_LATER || errc == DEVICE_UNABLE) && numInFlight > 0) break; //retry once some tasks complete
+    releaseTensors(); return -1;
+   }
+   if(node.Slot >= 0) slots[node.Slot].Busy = true;
+   node.Status = 1; ++numInFlight; issued = true;
+  }
+  //Finalize the completed tensor contractions (blocks on the oldest one if nothing else can progress):
+  bool waited = issued;
+  for(auto & node: nodes){
+   if(node.Status != 1) continue;
+   int stats, ierr;
+   if(!waited){
+    errc = taskWait(node.Task,&stats); waited = true;
+    if(errc != TALSH_SUCCESS){releaseTensors(); return -1;}
+   }else{
+    int done;
+#pragma omp critical(talsh_api)
+    done = talshTaskComplete(node.Task,&stats,&ierr);
+    if(ierr != TALSH_SUCCESS){releaseTensors(); return -1;}
+    if(done != YEP) continue;
+   }
+   if(stats != TALSH_TASK_COMPLETED){releaseTensors(); return -1;}
+#pragma omp critical(talsh_api)
+   errc = talshTaskDestroy(node.Task);
+   node.Task = nullptr; if(errc != TALSH_SUCCESS){releaseTensors(); return -1;}
+   node.Status = 2; --numInFlight; ++numDone;
+   for(const auto operand: node.Operand){ //memory slots of the intermediate input tensors are released
+    if(operand >= 0){
+     auto & slot = slots[nodes[operand].Slot];
+     slot.Busy = false; ++(slot.Turn);
+    }
+   }
   }
-
-  //std::cout << std::endl << "End of iteration " << contrNum << ". Press any key and enter to continue ..."; std::cin >> tmp; //debug
-
  }
+ nodes[numContractions - 1].Dest = nullptr; //output tensor alias is destroyed with the input tensor aliases
+ releaseTensors();
 
  auto timeEnd = std::chrono::high_resolution_clock::now();
  auto timeTot = std::chrono::duration_cast<std::chrono::duration<double>>(timeEnd-timeBeg);
  std::cout << std::endl << "Done (" << timeTot.count() << " sec)" << std::endl; //debug
  return error_code;
 }
+
+/** Performs all tensor contractions slice by slice, thus evaluating the value of the output tensor:
+    The values of a set of contracted legs are fixed in each slice such that the intermediate tensors
+    fit into the memory limit, the slices being evaluated concurrently by multiple threads as long as
+    their intermediate tensors fit into the memory limit together. Each thread accumulates its slices
+    into its own partial output, the partial outputs being summed into the output tensor at the end.
+    TAL-SH calls are not thread-safe, thus they are serialized (see computeOutputLocal()). **/
+template <typename T>
+int TensorNetwork<T>::computeOutputSliced(const ContractionSequence & contrSeq,
+                                          const std::size_t memLimit,
+                                          const std::size_t tensLimit)
+{
+ int error_code = 0; //success
+ std::cout << "#MSG(TensorNetwork<T>::computeOutputSliced): Slicing ... "; //debug
+
+ //Determine the sliced legs:
+ std::vector<std::vector<unsigned int>> legEdges;
+ const auto graph = this->getContractionGraph(&legEdges);
+ const double maxVolume = (memLimit > 0) ? static_cast<double>(memLimit / sizeof(T)) : std::numeric_limits<double>::infinity();
+ const double maxTensVolume = (tensLimit > 0) ? static_cast<double>(tensLimit / sizeof(T)) : std::numeric_limits<double>::infinity();
+ std::vector<unsigned int> slicedEdges;
+ const double totalCost = graph.determineSlicing(contrSeq,maxVolume,maxTensVolume,slicedEdges);
+ if(totalCost == std::numeric_limits<double>::infinity()){
+  std::cout << "Failed: Memory limit of " << memLimit << " bytes (" << tensLimit << " bytes per tensor) cannot be met" << std::endl; //debug
+  return -2;
+ }
+ if(slicedEdges.empty()){
+  std::cout << "Not needed" << std::endl; //debug
+  return this->computeOutputLocal(contrSeq);
+ }
+ long long numSlices = 1;
+ auto slicedGraph = graph;
+ for(const auto edgeId: slicedEdges){
+  numSlices *= static_cast<long long>(graph.getEdge(edgeId).Extent);
+  slicedGraph.resetEdgeExtent(edgeId,1);
+ }
+ int numThreads = 1; //number of concurrently evaluated slices
+#ifdef _OPENMP
+ numThreads = omp_get_max_threads();
+#endif
+ const double slicePeak = slicedGraph.getSequencePeakVolume(contrSeq);
+ if(slicePeak > 0.0) numThreads = static_cast<int>(std::max(1.0,std::min(static_cast<double>(numThreads),maxVolume/slicePeak)));
+ if(numSlices < numThreads) numThreads = static_cast<int>(numSlices);
+ std::cout << numSlices << " slices over " << slicedEdges.size() << " legs, Flop count = " << totalCost
+           << ", " << numThreads << " concurrent slices" << std::endl; //debug
+
+ //Evaluate the slices:
+ const auto & outTensor = this->getTensor(0);
+ const auto outVol = outTensor.getVolume();
+ auto outBody = outTensor.getBodyAccess();
+ assert(outBody); //output tensor must have been defined
+#pragma omp parallel num_threads(numThreads) shared(error_code,outBody)
+ {
+  std::shared_ptr<T> partBody(new T[outVol],[](T * ptr){delete[] ptr;}); //partial output of this thread
+  std::fill(partBody.get(),partBody.get()+outVol,T{});
+  std::vector<int> edgeOffsets(graph.getNumEdges(),-1); //offset of each sliced edge within the slice (-1: not sliced)
+#pragma omp for schedule(dynamic)
+  for(long long slice = 0; slice < numSlices; ++slice){
+   int errc;
+#pragma omp atomic read
+   errc = error_code;
+   if(errc != 0) continue;
+   auto sliceIndex = slice;
+   for(const auto edgeId: slicedEdges){
+    const auto extent = static_cast<long long>(graph.getEdge(edgeId).Extent);
+    edgeOffsets[edgeId] = static_cast<int>(sliceIndex % extent); sliceIndex /= extent;
+   }
+   errc = this->computeOutputSlice(contrSeq,legEdges,edgeOffsets,partBody);
+   if(errc != 0){
+#pragma omp atomic write
+    error_code = errc;
+   }
+  }
+#pragma omp critical
+  {
+   T * out = outBody.get(); const T * part = partBody.get();
+   for(std::size_t i = 0; i < outVol; ++i) out[i] += part[i];
+  }
+ }
+ return error_code;
+}
+
+/** Evaluates a single slice of the tensor network (with the values of
+    the sliced legs fixed), accumulating the result into an external body. **/
+template <typename T>
+int TensorNetwork<T>::computeOutputSlice(const ContractionSequence & contrSeq,
+                                         const std::vector<std::vector<unsigned int>> & legEdges,
+                                         const std::vector<int> & edgeOffsets,
+                                         std::shared_ptr<T> outBody) const
+{
+ int errc;
+ TensorNetwork<T> slicedNet;
+ const auto numTensors = this->getNumTensors();
+ for(unsigned int i = 0; i <= numTensors; ++i){
+  const auto & tensConn = this->getTensorConn(i);
+  const auto & tensor = tensConn.getTensor();
+  const int tRank = tensor.getRank();
+  std::vector<TensorLeg> legs;
+  std::size_t sDims[MAX_TENSOR_RANK];
+  int tDims[MAX_TENSOR_RANK], sliceDims[MAX_TENSOR_RANK], offsets[MAX_TENSOR_RANK];
+  bool sliced = false;
+  for(int j = 0; j < tRank; ++j){
+   legs.emplace_back(tensConn.getTensorLeg(j));
+   sDims[j] = tensor.getDimExtent(j); tDims[j] = static_cast<int>(sDims[j]); sliceDims[j] = tDims[j]; offsets[j] = 0;
+   if(i > 0 && edgeOffsets[legEdges[i][j]] >= 0){ //sliced leg
+    offsets[j] = edgeOffsets[legEdges[i][j]]; sDims[j] = 1; sliceDims[j] = 1; sliced = true;
+   }
+  }
+  std::shared_ptr<T> body = tensor.getBodyAccess();
+  if(i == 0){ //output tensor: partial result
+   body = outBody;
+  }else if(sliced){ //input tensor slice
+   talsh_tens_t *tens, *slice;
+   std::size_t vol = 1; for(int j = 0; j < tRank; ++j) vol *= sDims[j];
+   std::shared_ptr<T> sBody(new T[vol],[](T * ptr){delete[] ptr;});
+   std::fill(sBody.get(),sBody.get()+vol,T{}); //slicing scales the destination (uninitialized memory may contain NaN)
+#pragma omp critical(talsh_api)
+   {
+    errc = talshTensorCreate(&tens);
+    if(errc == TALSH_SUCCESS){
+     errc = talshTensorCreate(&slice);
+     if(errc == TALSH_SUCCESS){
+      errc = talshTensorConstruct(tens,TensorDataKind<T>::Type,tRank,tDims,talshFlatDevId(DEV_HOST,0),static_cast<void*>(body.get()));
+      if(errc == TALSH_SUCCESS)
+       errc = talshTensorConstruct(slice,TensorDataKind<T>::Type,tRank,sliceDims,talshFlatDevId(DEV_HOST,0),static_cast<void*>(sBody.get()));
+      if(errc == TALSH_SUCCESS) errc = talshTensorSlice(slice,tens,offsets,0,DEV_HOST);
+      talshTensorDestroy(slice);
+     }
+     talshTensorDestroy(tens);
+    }
+   }
+   if(errc != TALSH_SUCCESS) return -1;
+   body = sBody;
+  }
+  slicedNet.appendTensor(TensorDenseAdpt<T>(static_cast<unsigned int>(tRank),sDims,body),legs);
+ }
+ return slicedNet.computeOutputLocal(contrSeq);
+}
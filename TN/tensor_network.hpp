@@ -38,22 +38,30 @@
 #include <string>
 #include <ctime>
 #include <chrono>
+#include <limits>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "type_deduct.hpp"
 
 #include "tensor_conn.hpp"
+#include "contr_seq_optimizer.hpp"
+#include "contr_plan_cache.hpp"
 
 #include "tensor_define.hpp"
 
 #include "talsh.h"
+#include "mem_manager.h"
 
 #define _DEBUG_DIL
 
 namespace exatensor {
 
-//Types:
-using ContractionSequence = std::vector<std::pair<unsigned int, unsigned int>>;
-
 //Traits:
 template <typename DTK>
 struct TensorDataKind{
@@ -119,6 +127,11 @@ public:
  const TensorDenseAdpt<T> & getTensor(const unsigned int id) const;
  /** Returns a const reference to a specific tensor from the tensor network together with its connections. **/
  const TensorConn<T> & getTensorConn(const unsigned int id) const;
+ /** Returns the compact contraction graph of the tensor network (topology and leg extents only). **/
+ ContractionGraph getContractionGraph(std::vector<std::vector<unsigned int>> * legToEdge = nullptr) const; //out: edge id of each leg of each r.h.s. tensor
+ /** Returns the canonical topology key of the tensor network (tensor element type, tensor connections
+     and leg extents) under which its tensor contraction plan is cached (see ContrPlanCache). **/
+ std::string getTopologyKey() const;
  /** Prints. **/
  void printIt() const;
 
@@ -178,7 +191,9 @@ public:
  std::unique_ptr<TensorNetwork<T>> contractTensorsOut(const unsigned int tensId1, //in: id of the 1st tensor in the tensor network: [1..max]
                                                       const unsigned int tensId2, //in: id of the 2nd tensor in the tensor network: [1..max]
                                                       int * contrPattern = nullptr) const; //out: digital tensor contraction pattern
- /** Returns the computational cost of the specified contraction of two tensors. **/
+ /** Returns the computational cost of the specified contraction of two tensors.
+     If "rescale" is TRUE, the Flop cost of a memory-bound tensor contraction is
+     rescaled according to the default cost model (see ContrCostModel). **/
  double getContractionCost(const unsigned int tensId1,         //in: id of the 1st r.h.s. tensor (>0)
                            const unsigned int tensId2,         //in: id of the 2nd r.h.s. tensor (>0)
                            double * arithmIntensity = nullptr, //out: arithmetic intensity
@@ -187,7 +202,10 @@ public:
      for the given tensor network and numerically evaluates these
      tensor contractions to produce the value of the output tensor.
      If "contrSeq" already contains the previously determined
-     contraction sequence, it will be used immediately. **/
+     contraction sequence, it will be used immediately. Otherwise the contraction
+     sequence cached for the same tensor network topology will be reused, if any. If the intermediate
+     tensors will not fit into the TAL-SH Host buffer, the tensor network
+     will be evaluated in slices (returns -2 if slicing does not help either). **/
  int evaluate(ContractionSequence & contrSeq,                     //inout: tensor contraction sequence (either empty or previously determined)
               const unsigned int numWalkers = NumWalkersDefault); //in: optimization depth
  /** Determines a pseudo-optimal sequence of tensor contractions
@@ -199,6 +217,26 @@ public:
  int evaluate(ContractionSequence & contrSeq,                     //inout: tensor contraction sequence (either empty or previously determined)
               const std::shared_ptr<T> body,                      //in: externally provided pointer to the output tensor body
               const unsigned int numWalkers = NumWalkersDefault); //in: optimization depth
+ /** Determines a pseudo-optimal sequence of tensor contractions
+     for the given tensor network by means of a user-chosen optimizer
+     and numerically evaluates these tensor contractions to produce
+     the value of the output tensor. If "contrSeq" already contains
+     the previously determined contraction sequence, it will be used immediately.
+     The cost model of the optimizer is reset to the default cost model (see ContrCostModel)
+     for the tensor element type, thus capping intermediate tensors by the Host buffer size. **/
+ int evaluate(ContractionSequence & contrSeq,  //inout: tensor contraction sequence (either empty or previously determined)
+              ContrSeqOptimizer & optimizer); //in: tensor contraction sequence optimizer
+ /** Determines a pseudo-optimal sequence of tensor contractions
+     for the given tensor network and numerically evaluates these
+     tensor contractions to produce the value of the output tensor,
+     slicing the tensor network such that the intermediate tensors
+     fit into the given memory limit (also capped by the TAL-SH Host buffer).
+     The partial outputs of all slices are summed into the output tensor.
+     If "contrSeq" already contains the previously determined contraction sequence,
+     it will be used immediately, otherwise the cached one will be reused, if any. **/
+ int evaluateSliced(ContractionSequence & contrSeq,                     //inout: tensor contraction sequence (either empty or previously determined)
+                    const std::size_t memLimit,                         //in: memory limit for the intermediate tensors (bytes)
+                    const unsigned int numWalkers = NumWalkersDefault); //in: optimization depth
 
 private:
  /** Determines the pseudo-optimal tensor contraction sequence and returns
@@ -207,9 +245,35 @@ private:
      reduced tensor network (tensor numeration changes after each contraction). **/
  void getContractionSequence(ContractionSequence & contrSeq,       //out: contraction sequence
                              const unsigned int numWalkers) const; //in: optimization depth
+ /** Determines the pseudo-optimal tensor contraction sequence by means of a given optimizer. **/
+ void getContractionSequence(ContractionSequence & contrSeq,      //out: contraction sequence
+                             ContrSeqOptimizer & optimizer) const; //in: tensor contraction sequence optimizer
+ /** Returns the cost model of tensor contractions for the tensor element type. **/
+ ContrCostModel getCostModel() const;
+ /** Retrieves the tensor contraction plan for a given contraction sequence from the plan cache,
+     or builds it by replaying the contraction sequence symbolically and caches it. **/
+ int getContractionPlan(const ContractionSequence & contrSeq, //in: contraction sequence
+                        ContractionPlan & plan) const;        //out: tensor contraction plan
+ /** Returns TRUE if the intermediate tensors of a tensor contraction sequence will fit into the TAL-SH Host buffer
+     (each intermediate tensor within the max TAL-SH tensor size, all of them together within the buffer size). **/
+ bool fitsHostBuffer(const ContractionSequence & contrSeq) const; //in: contraction sequence
  /** Performs all tensor contractions, thus evaluating the value of the output tensor.
-     Single-node version based on TAL-SH. **/
+     Single-node version based on TAL-SH: Independent tensor contractions are
+     executed asynchronously via TAL-SH tasks, the intermediate tensors being
+     placed in the preallocated memory slots of the tensor contraction plan. **/
  int computeOutputLocal(const ContractionSequence & contrSeq); //in: contraction sequence
+ /** Performs all tensor contractions slice by slice, thus evaluating the value of the output tensor,
+     with the sliced legs chosen such that the intermediate tensors fit into the memory limits.
+     The slices are evaluated concurrently by multiple threads as long as their intermediate
+     tensors fit into the memory limit together. **/
+ int computeOutputSliced(const ContractionSequence & contrSeq, //in: contraction sequence
+                         const std::size_t memLimit,           //in: memory limit for all intermediate tensors together (bytes): 0 means unlimited
+                         const std::size_t tensLimit = 0);     //in: memory limit for a single intermediate tensor (bytes): 0 means unlimited
+ /** Evaluates a single slice of the tensor network, accumulating the result into an external body. **/
+ int computeOutputSlice(const ContractionSequence & contrSeq,                    //in: contraction sequence
+                        const std::vector<std::vector<unsigned int>> & legEdges, //in: edge id of each leg of each r.h.s. tensor
+                        const std::vector<int> & edgeOffsets,                    //in: fixed value of each sliced edge (-1 for other edges)
+                        std::shared_ptr<T> outBody) const;                       //in: output tensor body for the slice
 
 };
 
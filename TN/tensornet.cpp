@@ -25,6 +25,10 @@
 
 #include "tensornet.hpp"
 
+#include <cstring>
+#include <memory>
+#include <algorithm>
+
 namespace exatensor {
 
 /** Starts ExaTENSOR numerical runtime. **/
@@ -34,6 +38,55 @@ int start(std::size_t hostMemBufferSize){
  for(int i = 0; i < nGPU; ++i) listGPU[i]=i;
  errc = talshInit(&hostMemBufferSize,&hostArgMax,nGPU,listGPU,0,NULL,0,NULL);
  if(errc != TALSH_SUCCESS) return -1;
+ errc = calibrate(); if(errc != 0) return -3;
+ return 0;
+}
+
+/** Measures the sustained Flop rate and memory bandwidth of the Host and
+    sets up the default cost model of tensor contractions accordingly,
+    with the size of intermediate tensors capped by the Host argument buffer.
+    The Host Flop counter of TAL-SH is not maintained, thus the Flop rate is
+    measured by timing a matrix multiplication executed by TAL-SH. **/
+int calibrate(){
+ const int MAT_DIM = 256;                     //matrix dimension for the Flop rate measurement
+ const std::size_t COPY_SIZE = 1 << 25;       //size of the memory copy for the bandwidth measurement (bytes)
+ const int NUM_REPEATS = 3;                   //number of repeats (the best one is taken)
+ using Clock = std::chrono::high_resolution_clock;
+ int errc;
+ //Measure the memory bandwidth:
+ std::vector<char> src(COPY_SIZE,1), dst(COPY_SIZE,0);
+ double copyTime = 0.0;
+ for(int rep = 0; rep < NUM_REPEATS; ++rep){
+  auto timeBeg = Clock::now();
+  std::memcpy(dst.data(),src.data(),COPY_SIZE);
+  auto timeEnd = Clock::now();
+  double tm = std::chrono::duration_cast<std::chrono::duration<double>>(timeEnd-timeBeg).count();
+  if(rep == 0 || tm < copyTime) copyTime = tm;
+ }
+ double bandwidth = 2.0 * static_cast<double>(COPY_SIZE) / std::max(copyTime,1e-9); //read + write
+ //Measure the Flop rate:
+ struct TensorDestroyer{void operator()(talsh_tens_t * tens) const {talshTensorDestroy(tens);}};
+ std::unique_ptr<talsh_tens_t,TensorDestroyer> tens[3]; //destination, left, right (destroyed on any return)
+ const double initVal[3] = {0.0,0.5,0.5};
+ int dims[2] = {MAT_DIM,MAT_DIM};
+ for(int i = 0; i < 3; ++i){
+  talsh_tens_t * tensPtr;
+  errc = talshTensorCreate(&tensPtr); if(errc != TALSH_SUCCESS) return -1;
+  tens[i].reset(tensPtr);
+  errc = talshTensorConstruct(tensPtr,R8,2,dims,talshFlatDevId(DEV_HOST,0),NULL,-1,NULL,initVal[i]); if(errc != TALSH_SUCCESS) return -1;
+ }
+ double contrTime = 0.0;
+ for(int rep = 0; rep < NUM_REPEATS; ++rep){
+  auto timeBeg = Clock::now();
+  errc = talshTensorContract("D(a,b)+=L(a,c)*R(c,b)",tens[0].get(),tens[1].get(),tens[2].get(),1.0,0.0,0,DEV_HOST);
+  if(errc != TALSH_SUCCESS) return -1;
+  auto timeEnd = Clock::now();
+  double tm = std::chrono::duration_cast<std::chrono::duration<double>>(timeEnd-timeBeg).count();
+  if(rep == 0 || tm < contrTime) contrTime = tm;
+ }
+ double flops = static_cast<double>(MAT_DIM) * static_cast<double>(MAT_DIM) * static_cast<double>(MAT_DIM);
+ double flopRate = flops / std::max(contrTime,1e-9);
+ ContrCostModel::setDefault(ContrCostModel(flopRate,bandwidth,sizeof(double),talshDeviceTensorSize(0,DEV_HOST)));
  return 0;
 }
 
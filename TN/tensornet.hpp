@@ -32,6 +32,7 @@ namespace exatensor {
 
  int start(std::size_t hostMemBufferSize);
  int stop();
+ int calibrate();
 
 } //end namespace exatensor
 